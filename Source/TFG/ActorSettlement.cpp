@@ -3,6 +3,7 @@
 
 #include "ActorSettlement.h"
 
+#include "ActorTileMap.h"
 #include "FProductionElement.h"
 #include "GInstance.h"
 #include "LibraryDataTables.h"
@@ -47,29 +48,18 @@ void AActorSettlement::OwnTileInRange()
 	// Se verifica que la instancia del mapa sea valida
 	if (!TileMap) return;
 
-	// Se crean contenedores para almacenar las casillas de los anillos exteriores
-	TArray<FIntPoint> RangeTwo = TArray<FIntPoint>();
-	TArray<FIntPoint> RangeThree = TArray<FIntPoint>();
-
-	// Se obtienen todas las casillas dentro del rango de expansion y se procesan
-	TArray<FIntPoint> InRange = TileMap->GetTilesWithinRange(Info.Pos2D, 3, false, false);
-	for (const auto TilePos : InRange)
+	// Se busca la primera casilla sin propietario de los anillos exteriores, dando preferencia al anillo de radio 2
+	FIntPoint TileToOwn = FIntPoint(-1);
+	for (int32 Radius = 2; Radius <= 3 && TileToOwn == -1; ++Radius)
 	{
-		// Si la casilla ya tiene propietario, se omite
-		if (!TileMap->IsTileOwned(TilePos))
+		ULibraryTileMap::ForEachTileInRing(Info.Pos2D, Radius, TileMap->GetSize(), [&](const FIntPoint& TilePos)
 		{
-			// Se calcula la distancia
-			const int32 Distance = ULibraryTileMap::GetDistanceToElement(Info.Pos2D, TilePos);
-
-			// Se clasifica segun el resultado
-			if (Distance == 2) RangeTwo.Add(TilePos);
-			else if (Distance == 3) RangeThree.Add(TilePos);
-		}
+			if (TileToOwn == -1 && !TileMap->IsTileOwned(TilePos)) TileToOwn = TilePos;
+		});
 	}
 
-	// Si se han obtenido casillas, se establece la propiedad de una de ellas
-	if (RangeTwo.Num() > 0) OwnTile(RangeTwo[0]);
-	else if (RangeThree.Num() > 0) OwnTile(RangeThree[0]);
+	// Si se ha obtenido una casilla, se establece su propiedad
+	if (TileToOwn != -1) OwnTile(TileToOwn);
 
 	// Se actualiza el contador de turnos
 	Info.TurnsToOwnTile = 5;
@@ -91,7 +81,7 @@ void AActorSettlement::SetInitialOwnedTiles()
 	OwnTile(Info.Pos2D);
 
 	// Se realiza el mismo procedimiento con las casillas vecinas
-	for (const FIntPoint Pos : ULibraryTileMap::GetNeighbors(Info.Pos2D, MapSize)) OwnTile(Pos);
+	ULibraryTileMap::ForEachNeighbor(Info.Pos2D, MapSize, [this](const FIntPoint& Pos) { OwnTile(Pos); });
 }
 
 void AActorSettlement::DisownTile(const FIntPoint& Pos)
@@ -51,6 +51,13 @@ public:
 	UFUNCTION(BlueprintCallable)
 	const FVector2D& GetMapPos() const { return Info.MapPos2D; }
 
+	/**
+	 * Getter del atributo Info
+	 * 
+	 * @return Informacion de la casilla
+	 */
+	const FTileInfo& GetInfo() const { return Info; }
+
 	/**
 	 * Getter del atributo Type
 	 * 
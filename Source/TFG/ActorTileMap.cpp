@@ -12,6 +12,8 @@
 #include "SaveMainGame.h"
 #include "SMain.h"
 #include "TPriorityQueue.h"
+#include "Async/ParallelFor.h"
+#include "Async/TaskGraphInterfaces.h"
 #include "Kismet/GameplayStatics.h"
 
 AActorTileMap::AActorTileMap()
@@ -247,9 +249,18 @@ void AActorTileMap::SetTileAtPos(const FIntPoint& Pos2D, const int32 FactionOwne
 	// Se inicializa la informacion de la casilla
 	const FTileInfo TileInfo = FTileInfo(Pos2D, GridSize, FactionOwner, TileType, FTileElements(), {TileState});
 
-	// Se anade la informacion de la casilla al diccionario que la almacena
-	if (!TilesInfo.Contains(Pos2D)) TilesInfo.Add(Pos2D, TileInfo);
-	else TilesInfo[Pos2D] = TileInfo;
+	// Se anade la informacion de la casilla al diccionario que la almacena y se actualiza la rejilla de casillas
+	const int32 Index = GetPositionInArray(Pos2D);
+	if (Index != -1)
+	{
+		TilesInfo.Add(Pos2D, TileInfo);
+
+		if (Index < Grid.Num())
+		{
+			Grid.SetType(Index, TileType);
+			Grid.Owners[Index] = static_cast<int8>(FactionOwner);
+		}
+	}
 
 	// Se actualiza el diccionaro que almacena el conteo de casillas por tipo
 	TileTypeCount[TileType] += 1;
@@ -280,6 +291,9 @@ void AActorTileMap::SetMapFromSave(const TArray<FTileSaveData>& TilesData)
 	// Se inicializa el array de casillas
 	if (TilesData.Num() != Tiles.Num()) Tiles.SetNum(TilesData.Num());
 
+	// Se inicializa la rejilla de casillas para las nuevas dimensiones
+	Grid.Init(Rows, Cols);
+
 	// Se procesan todas las casillas del archivo de guardado
 	for (int32 i = 0; i < TilesData.Num(); ++i)
 	{
@@ -299,11 +313,11 @@ void AActorTileMap::SetMapFromSave(const TArray<FTileSaveData>& TilesData)
 			OnTileUpdated.Broadcast(TilesInfo[Pos]);
 		}
 		// En caso contrario, se actualizan sus datos
-		else if (Index != -1 && Tiles[Index])
+		else if (Index != -1 && Tiles[Index] && TilesInfo.Contains(Pos))
 		{
 			// Se obtiene la casilla y sus propiedades
 			AActorTile* Tile = Tiles[Index];
-			const FTileInfo TileInfo = TilesInfo[Pos];
+			const FTileInfo& TileInfo = TilesInfo[Pos];
 
 			// Se actualizan los datos de la casilla
 			Tile->SetFactionOwner(TileInfo.Owner);
@@ -313,6 +327,13 @@ void AActorTileMap::SetMapFromSave(const TArray<FTileSaveData>& TilesData)
 			OnTileOwnerUpdated.Broadcast(TileInfo);
 		}
 	}
+
+	// Se calculan las componentes conexas del mapa cargado y se preparan los clusters de la busqueda jerarquica
+	Grid.BuildComponents();
+	ClusterGraph.Init(Grid);
+	ResetTileChanges();
+	RebuildSettlementFields();
+	Occupancy.Init(Grid);
 }
 
 //--------------------------------------------------------------------------------------------------------------------//
@@ -334,7 +355,7 @@ TArray<FIntPoint> AActorTileMap::GetClosestTilesFromPos(int32 NeededPositions, c
 	FIntPoint CurrentPos = CenterPos;
 
 	// Se crean las variables para gestionar las casillas vecinas
-	TArray<FIntPoint> CurrentNeighbors;
+	FTileNeighbors CurrentNeighbors;
 	FIntPoint FirstNeighbor = CenterPos;
 
 	// Se procesa por cada casilla que sea necesaria
@@ -343,7 +364,7 @@ TArray<FIntPoint> AActorTileMap::GetClosestTilesFromPos(int32 NeededPositions, c
 		// Si no hay casillas, se generan
 		if (CurrentNeighbors.Num() == 0)
 		{
-			CurrentNeighbors = ULibraryTileMap::GetNeighbors(FirstNeighbor, FIntPoint(Rows, Cols));
+			ULibraryTileMap::FillNeighbors(FirstNeighbor, FIntPoint(Rows, Cols), CurrentNeighbors);
 			FirstNeighbor = CurrentNeighbors[0];
 		}
 
@@ -357,7 +378,7 @@ TArray<FIntPoint> AActorTileMap::GetClosestTilesFromPos(int32 NeededPositions, c
 			// Si no hay casillas, se vuelven a generar
 			if (CurrentNeighbors.Num() == 0)
 			{
-				CurrentNeighbors = ULibraryTileMap::GetNeighbors(FirstNeighbor, FIntPoint(Rows, Cols));
+				ULibraryTileMap::FillNeighbors(FirstNeighbor, FIntPoint(Rows, Cols), CurrentNeighbors);
 				FirstNeighbor = CurrentNeighbors[0];
 			}
 
@@ -389,6 +410,12 @@ int32 AActorTileMap::GetPositionInArray(const int32 Row, const int32 Col) const
 	return IsValid && (Index = Row * Cols + Col) < Tiles.Num() ? Index : -1;
 }
 
+int32 AActorTileMap::GetCurrentFaction() const
+{
+	const ASMain* State = Cast<ASMain>(UGameplayStatics::GetGameState(GetWorld()));
+	return State ? State->GetCurrentIndex() : -1;
+}
+
 //--------------------------------------------------------------------------------------------------------------------//
 
 bool AActorTileMap::AreTilesValid() const
@@ -406,11 +433,63 @@ AActorTile* AActorTileMap::GetTileAtPos(const FIntPoint& Pos) const
 	return Index != -1 && Tiles[Index] ? Tiles[Index] : nullptr;
 }
 
+FTileInfo AActorTileMap::GetTileInfoAtPos(const FIntPoint& Pos) const
+{
+	// Se obtiene la informacion del diccionario, que incluye los estados que modifica Blueprint. Si no existe, se
+	// devuelve una informacion por defecto
+	return TilesInfo.FindRef(Pos);
+}
+
 TArray<FIntPoint> AActorTileMap::GetTilesWithState(const ETileState State) const
 {
 	return TilesWithState.Contains(State) ? TilesWithState[State].TilesArray : TArray<FIntPoint>();
 }
 
+bool AActorTileMap::AreTilesConnected(const FIntPoint& PosA, const FIntPoint& PosB) const
+{
+	// Se verifica que las posiciones sean validas
+	const int32 IndexA = Grid.GetIndex(PosA);
+	const int32 IndexB = Grid.GetIndex(PosB);
+	if (IndexA == -1 || IndexB == -1) return false;
+
+	return Grid.AreConnected(IndexA, IndexB);
+}
+
+void AActorTileMap::RegisterTileChange(const int32 Index)
+{
+	// Mientras se genera o carga el mapa no se registran cambios, el registro se vacia al terminar
+	if (!Grid.ComponentsBuilt) return;
+
+	// Si el registro esta lleno, se descarta la mitad mas antigua
+	if (TileChanges.Num() >= MaxTileChanges)
+	{
+		const int32 NumRemoved = MaxTileChanges / 2;
+		TileChanges.RemoveAt(0, NumRemoved, false);
+		FirstTileChangeVersion += NumRemoved;
+	}
+
+	TileChanges.Add(Index);
+	++MapVersion;
+}
+
+void AActorTileMap::ResetTileChanges()
+{
+	TileChanges.Reset();
+	FirstTileChangeVersion = ++MapVersion;
+}
+
+void AActorTileMap::RebuildSettlementFields()
+{
+	SettlementFields.Empty();
+	for (int32 Index = 0; Index < Grid.Num(); ++Index)
+	{
+		if (!Grid.HasSettlement(Index)) continue;
+
+		FSettlementDistanceField& Field = SettlementFields.FindOrAdd(Grid.SettlementOwners[Index]);
+		Field.AddSettlement(Grid, Index);
+	}
+}
+
 //--------------------------------------------------------------------------------------------------------------------//
 
 void AActorTileMap::GenerateMap(const FIntPoint& Size2D, const EMapTemperature Temperature, const EMapSeaLevel SeaLevel,
@@ -449,8 +528,12 @@ void AActorTileMap::GenerateMap(const FIntPoint& Size2D, const EMapTemperature T
 	TArray<FTileProbability> Probabilities;
 
 	Tiles.SetNum(Dimension);
+	TilesInfo.Empty(Dimension);
 	Probabilities.SetNumZeroed(Dimension);
 
+	// Se inicializa la rejilla de casillas para las nuevas dimensiones
+	Grid.Init(Rows, Cols);
+
 	// Se inicializa el array de probabilidaddes con los valores calculados o por defecto en funcion del tipo de casilla
 	for (int32 Pos = 0, IceRow = -1; Pos < Dimension; ++Pos)
 	{
@@ -478,6 +561,13 @@ void AActorTileMap::GenerateMap(const FIntPoint& Size2D, const EMapTemperature T
 		}
 	}
 
+	// Se calculan las componentes conexas del mapa generado y se preparan los clusters de la busqueda jerarquica
+	Grid.BuildComponents();
+	ClusterGraph.Init(Grid);
+	ResetTileChanges();
+	RebuildSettlementFields();
+	Occupancy.Init(Grid);
+
 	// Se actualizan los parametros de la instancia del juego para poder usarlos mas adelante
 	UGInstance* GameInstance = Cast<UGInstance>(UGameplayStatics::GetGameInstance(GetWorld()));
 	if (GameInstance)
@@ -573,20 +663,33 @@ void AActorTileMap::UpdateTileAtPos(const FIntPoint& Pos, const int32 FactionOwn
 		Tiles[Index] = nullptr;
 
 		// Se verifica que la informacion de la casilla que se esta procesando es valida
-		if (TilesInfo.Contains(Pos))
+		if (const FTileInfo* TileInfo = TilesInfo.Find(Pos))
 		{
-			// Se obtiene el tipo previo de la casilla
-			const ETileType PreviousTileType = TilesInfo[Pos].Type;
+			// Se actualiza el diccionario que almacena el conteo de casillas por tipo con el tipo previo
+			TileTypeCount[TileInfo->Type] -= 1;
 
-			// Se elimina la informacion de la casilla al diccionario que la almacena
+			// Se elimina la informacion de la casilla del diccionario que la almacena
 			TilesInfo.Remove(Pos);
-			// Se actualiza el diccionario que almacena el conteo de casillas por tipo
-			TileTypeCount[PreviousTileType] -= 1;
 		}
 	}
 
+	// Se almacenan la accesibilidad y el coste previos de la casilla para actualizar las estructuras derivadas
+	const bool WasAccesible = Index < Grid.Num() && Grid.IsAccesible(Index);
+	const int32 PreviousCost = Index < Grid.Num() ? Grid.Costs[Index] : -1;
+
 	// Se actualizan los datos de la casilla
 	SetTileAtPos(Pos, FactionOwner, TileType);
+
+	// Se actualizan las componentes conexas afectadas por el cambio y se marca el cluster para recalcularse
+	if (Index < Grid.Num())
+	{
+		Grid.UpdateComponentsAt(Index, WasAccesible);
+		if (Grid.Costs[Index] != PreviousCost)
+		{
+			ClusterGraph.MarkDirty(Grid, Index);
+			RegisterTileChange(Index);
+		}
+	}
 }
 
 void AActorTileMap::DisplayTileAtPos(const TSubclassOf<AActorTile> Tile, const FTileInfo& TileInfo)
@@ -630,7 +733,9 @@ void AActorTileMap::SetTileFactionOwner(const FIntPoint& Pos, const int32 Factio
 	Tiles[Index]->SetFactionOwner(FactionOwner);
 
 	// Se actualiza la informacion del mapa
-	TilesInfo[Pos].Owner = FactionOwner;
+	UpdateTileInfo(Pos, [FactionOwner](FTileInfo& TileInfo) { TileInfo.Owner = FactionOwner; });
+	Grid.Owners[Index] = static_cast<int8>(FactionOwner);
+	RegisterTileChange(Index);
 }
 
 void AActorTileMap::AddResourceToTile(const FIntPoint& Pos, const TSubclassOf<AActorResource> ResourceClass,
@@ -660,14 +765,16 @@ void AActorTileMap::AddResourceToTile(const FIntPoint& Pos, const TSubclassOf<AA
 
 		// Se asigna el recurso a la casilla
 		Tile->SetResource(NewResource);
-		if (TilesInfo.Contains(Pos)) TilesInfo[Pos].Elements.Resource = NewResource;
+		UpdateTileInfo(Pos, [NewResource](FTileInfo& TileInfo) { TileInfo.Elements.Resource = NewResource; });
 
 		// Se actualiza el contador de recursos
 		ResourceCount[Resource.Resource] += 1;
+		Grid.Resources[Index] = Resource.Resource;
+		RegisterTileChange(Index);
 	}
 
 	// Se llama al evento para actualiza la interfaz
-	OnResourceCreated.Broadcast(TilesInfo[Pos].Elements.Resource);
+	OnResourceCreated.Broadcast(Tile->GetInfo().Elements.Resource);
 }
 
 void AActorTileMap::RemoveResourceFromTile(const FIntPoint& Pos)
@@ -686,7 +793,9 @@ void AActorTileMap::RemoveResourceFromTile(const FIntPoint& Pos)
 
 		// Se elimina el recurso de la casilla
 		Tile->SetResource(nullptr);
-		if (TilesInfo.Contains(Pos)) TilesInfo[Pos].Elements.Resource = nullptr;
+		UpdateTileInfo(Pos, [](FTileInfo& TileInfo) { TileInfo.Elements.Resource = nullptr; });
+		Grid.Resources[Index] = EResource::None;
+		RegisterTileChange(Index);
 	}
 }
 
@@ -700,7 +809,10 @@ void AActorTileMap::AddUnitToTile(const FIntPoint& Pos, AActorUnit* Unit)
 	Tiles[Index]->SetUnit(Unit);
 
 	// Se actualiza la informacion de la casilla
-	TilesInfo[Pos].Elements.Unit = Unit;
+	UpdateTileInfo(Pos, [Unit](FTileInfo& TileInfo) { TileInfo.Elements.Unit = Unit; });
+	Grid.SetUnit(Index, Unit ? Unit->GetFactionOwner() : -1, Unit != nullptr);
+	Occupancy.UpdateTile(Grid, Index);
+	RegisterTileChange(Index);
 }
 
 void AActorTileMap::RemoveUnitFromTile(const FIntPoint& Pos)
@@ -713,7 +825,10 @@ void AActorTileMap::RemoveUnitFromTile(const FIntPoint& Pos)
 	Tiles[Index]->SetUnit(nullptr);
 
 	// Se actualiza la informacion de la casilla
-	TilesInfo[Pos].Elements.Unit = nullptr;
+	UpdateTileInfo(Pos, [](FTileInfo& TileInfo) { TileInfo.Elements.Unit = nullptr; });
+	Grid.SetUnit(Index, -1, false);
+	Occupancy.UpdateTile(Grid, Index);
+	RegisterTileChange(Index);
 }
 
 void AActorTileMap::AddSettlementToTile(const FIntPoint& Pos, AActorSettlement* Settlement)
@@ -726,7 +841,13 @@ void AActorTileMap::AddSettlementToTile(const FIntPoint& Pos, AActorSettlement*
 	Tiles[Index]->SetSettlement(Settlement);
 
 	// Se actualiza la informacion de la casilla
-	TilesInfo[Pos].Elements.Settlement = Settlement;
+	UpdateTileInfo(Pos, [Settlement](FTileInfo& TileInfo) { TileInfo.Elements.Settlement = Settlement; });
+	Grid.SetSettlement(Index, Settlement ? Settlement->GetFactionOwner() : -1, Settlement != nullptr);
+	Occupancy.UpdateTile(Grid, Index);
+	RegisterTileChange(Index);
+
+	// Se actualiza la distancia al asentamiento mas cercano de la faccion propietaria
+	if (Settlement) SettlementFields.FindOrAdd(Grid.SettlementOwners[Index]).AddSettlement(Grid, Index);
 
 	// Se actualiza el contenedor de posiciones de asentamientos
 	SettlementsPos.Add(Pos);
@@ -742,12 +863,56 @@ void AActorTileMap::RemoveSettlementFromTile(const FIntPoint& Pos)
 	Tiles[Index]->SetSettlement(nullptr);
 
 	// Se actualiza la informacion de la casilla
-	TilesInfo[Pos].Elements.Settlement = nullptr;
+	UpdateTileInfo(Pos, [](FTileInfo& TileInfo) { TileInfo.Elements.Settlement = nullptr; });
+
+	// Se actualiza la distancia al asentamiento mas cercano de la faccion que lo poseia
+	if (FSettlementDistanceField* Field = SettlementFields.Find(Grid.SettlementOwners[Index]))
+	{
+		Field->RemoveSettlement(Grid, Index);
+	}
+
+	Grid.SetSettlement(Index, -1, false);
+	Occupancy.UpdateTile(Grid, Index);
+	RegisterTileChange(Index);
 
 	// Se actualiza el contenedor de posiciones de asentamientos
 	if (SettlementsPos.Contains(Pos)) SettlementsPos.Remove(Pos);
 }
 
+void AActorTileMap::UpdateElementsOwner(const FIntPoint& Pos)
+{
+	// Se verifica que la posicion sea valida
+	const int32 Index = GetPositionInArray(Pos);
+	if (Index == -1 || !Grid.IsValidIndex(Index) || !HasTile(Index)) return;
+
+	// Se obtienen las facciones actuales de los elementos de la casilla
+	const FTileElements& Elements = Tiles[Index]->GetInfo().Elements;
+	const int32 UnitOwner = Elements.Unit ? Elements.Unit->GetFactionOwner() : -1;
+	const int32 SettlementOwner = Elements.Settlement ? Elements.Settlement->GetFactionOwner() : -1;
+
+	// Si las facciones no han cambiado, no se modifica el mapa
+	const bool UnitChanged = Elements.Unit && Grid.UnitOwners[Index] != UnitOwner;
+	const bool SettlementChanged = Elements.Settlement && Grid.SettlementOwners[Index] != SettlementOwner;
+	if (!UnitChanged && !SettlementChanged) return;
+
+	if (UnitChanged) Grid.SetUnit(Index, UnitOwner, true);
+
+	if (SettlementChanged)
+	{
+		// Se mueve el asentamiento de la distancia de la faccion que lo poseia a la de la nueva faccion
+		if (FSettlementDistanceField* Field = SettlementFields.Find(Grid.SettlementOwners[Index]))
+		{
+			Field->RemoveSettlement(Grid, Index);
+		}
+
+		Grid.SetSettlement(Index, SettlementOwner, true);
+		SettlementFields.FindOrAdd(SettlementOwner).AddSettlement(Grid, Index);
+	}
+
+	Occupancy.UpdateTile(Grid, Index);
+	RegisterTileChange(Index);
+}
+
 //--------------------------------------------------------------------------------------------------------------------//
 
 FString AActorTileMap::SaveMap(const FString CustomName) const
@@ -761,15 +926,20 @@ FString AActorTileMap::SaveMap(const FString CustomName) const
 
 		MapSaveInstance->WaterTileChance = WaterTileChance;
 
-		// Se inicializa la estructura de casillas con la informacion del mapa actual
-		for (auto Tile : TilesInfo)
+		// Se inicializa la estructura de casillas con la informacion del mapa actual. Las casillas se recorren en
+		// orden, por lo que la ultima casilla guardada es la de mayor fila y columna
+		MapSaveInstance->Tiles.Reserve(TilesInfo.Num());
+		for (int32 Index = 0; Index < Tiles.Num(); ++Index)
 		{
-			MapSaveInstance->Tiles.Add(FTileSaveData(Tile.Key, Tile.Value.Owner, Tile.Value.Type));
+			if (!HasTile(Index)) continue;
+
+			const FTileInfo& Tile = Tiles[Index]->GetInfo();
+			MapSaveInstance->Tiles.Add(FTileSaveData(Tile.Pos2D, Tile.Owner, Tile.Type));
 
 			// Si contiene un recurso, se anade a la lista de recursos del mapa
-			if (Tile.Value.Elements.Resource)
+			if (Tile.Elements.Resource)
 			{
-				MapSaveInstance->Resources.Add(Tile.Value.Elements.Resource->GetInfo());
+				MapSaveInstance->Resources.Add(Tile.Elements.Resource->GetInfo());
 			}
 		}
 
@@ -1063,7 +1233,7 @@ bool AActorTileMap::IsTileAccesible(const FIntPoint& Pos) const
 {
 	// Se verifica el indice, si no es correcto, se devuelve 'false'
 	const int32 Index = GetPositionInArray(Pos);
-	return Index != -1 && Tiles[Index] ? Tiles[Index]->IsAccesible() : false;
+	return Index != -1 && Grid.IsAccesible(Index);
 }
 
 bool AActorTileMap::IsTileOwned(const FIntPoint& Pos2D) const
@@ -1071,15 +1241,18 @@ bool AActorTileMap::IsTileOwned(const FIntPoint& Pos2D) const
 	// Se verifica que la casilla sea valida
 	const int32 Index = GetPositionInArray(Pos2D);
 
-	return Index != -1 && Tiles[Index] ? Tiles[Index]->IsOwned() : false;
+	return Index != -1 && Grid.Owners[Index] != -1;
 }
 
 bool AActorTileMap::IsTileMine(const FIntPoint& Pos2D) const
 {
 	// Se verifica que la casilla sea valida
 	const int32 Index = GetPositionInArray(Pos2D);
+	if (Index == -1) return false;
 
-	return Index != -1 && Tiles[Index] ? Tiles[Index]->IsMine() : false;
+	// Se comprueba si el propietario es la faccion en juego
+	const int32 CurrentFaction = GetCurrentFaction();
+	return CurrentFaction != -1 && Grid.Owners[Index] == CurrentFaction;
 }
 
 bool AActorTileMap::TileHasResource(const FIntPoint& Pos2D) const
@@ -1087,26 +1260,26 @@ bool AActorTileMap::TileHasResource(const FIntPoint& Pos2D) const
 	// Se verifica que la casilla sea valida
 	const int32 Index = GetPositionInArray(Pos2D);
 
-	return Index != -1 && Tiles[Index] ? Tiles[Index]->HasResource() : false;
+	return Index != -1 && Grid.HasResource(Index);
 }
 
 bool AActorTileMap::CanGatherResourceAtPos(const FIntPoint& Pos2D) const
 {
-	// Se verifica que la casilla sea valida
+	// Se verifica que la casilla sea valida y contenga un recurso
 	const int32 Index = GetPositionInArray(Pos2D);
-	if (Index == -1 || !Tiles[Index]) return false;
+	if (Index == -1 || !Tiles[Index] || !Grid.HasResource(Index)) return false;
 
 	// Se obtiene el recurso
 	const AActorResource* Resource = Tiles[Index]->GetResource();
 
-	return Tiles[Index]->IsMine() && Resource && !Resource->IsGathered();
+	return IsTileMine(Pos2D) && Resource && !Resource->IsGathered();
 }
 
 bool AActorTileMap::IsResourceGathered(const FIntPoint& Pos2D) const
 {
-	// Se verifica que la casilla sea valida
+	// Se verifica que la casilla sea valida y contenga un recurso
 	const int32 Index = GetPositionInArray(Pos2D);
-	if (Index == -1 || !Tiles[Index]) return false;
+	if (Index == -1 || !Tiles[Index] || !Grid.HasResource(Index)) return false;
 
 	// Se obtiene el recurso
 	const AActorResource* Resource = Tiles[Index]->GetResource();
@@ -1118,84 +1291,212 @@ bool AActorTileMap::TileHasElement(const FIntPoint& Pos2D) const
 {
 	// Se verifica que la casilla sea valida
 	const int32 Index = GetPositionInArray(Pos2D);
-	if (Index == -1 || !Tiles[Index]) return false;
 
-	return Tiles[Index]->GetElement() != nullptr;
+	return Index != -1 && Grid.HasElement(Index);
 }
 
 bool AActorTileMap::TileHasEnemyOrAlly(const FIntPoint& Pos2D, const bool CheckEnemy) const
 {
-	// Se verifica que la casilla sea valida
+	// Se verifica que la casilla sea valida y que contenga un elemento
 	const int32 Index = GetPositionInArray(Pos2D);
-	if (Index == -1 || !Tiles[Index]) return false;
-
-	// Se obtiene el elemento que contiene la casilla
-	const AActorDamageableElement* Element = Tiles[Index]->GetElement();
+	if (Index == -1 || !Grid.HasElement(Index)) return false;
 
 	// Se comprueba si el elemento es propiedad de la faccion actual
-	const bool IsMine = Element && Element->IsMine();
+	const int32 CurrentFaction = GetCurrentFaction();
+	const bool IsMine = CurrentFaction != -1 && Grid.GetElementOwner(Index) == CurrentFaction;
 
 	// Se verifica si el elemento es propio o no
-	return Element && CheckEnemy ? !IsMine : IsMine;
+	return CheckEnemy ? !IsMine : IsMine;
 }
 
-TArray<FIntPoint> AActorTileMap::GetTilesWithinRange(const FIntPoint& Pos2D, const int32 Range,
-                                                     const bool CheckTileCost, const bool CheckTileAccesibility)
+void AActorTileMap::GetEnemiesOrAlliesInRange(const FIntPoint& Pos2D, const int32 Range, const bool CheckEnemy,
+                                              const bool CheckTileAccesibility, TSet<FIntPoint>& OutElements) const
 {
-	// Se inicializa la lista de casillas alcanzables
-	TArray<FIntPoint> InRange = TArray<FIntPoint>();
+	// Se verifica que la posicion sea valida
+	const int32 IndexIni = GetPositionInArray(Pos2D);
+	if (IndexIni == -1) return;
+
+	// Se obtienen una unica vez las facciones buscadas: la propia para los aliados y el resto para los enemigos
+	const uint64 CurrentMask = FOccupancyIndex::GetFactionMask(GetCurrentFaction());
+	const uint64 FactionMask = CheckEnemy ? ~CurrentMask : GetCurrentFaction() != -1 ? CurrentMask : 0;
+
+	// Se obtienen los candidatos de los cubos con elementos de las facciones buscadas
+	TArray<int32, TInlineAllocator<16>> Candidates;
+	Occupancy.ForEachElementInRange(Grid, Pos2D, Range, FactionMask, [&Candidates](const int32 Index)
+	{
+		Candidates.Add(Index);
+	});
+
+	if (!CheckTileAccesibility)
+	{
+		for (const int32 Index : Candidates) OutElements.Add(GetCoordsInMap(Index));
+		return;
+	}
 
-	// Si no se tiene alcance, no se realiza ningun procesamiento
-	if (Range > 0)
+	if (Candidates.Num() == 0) return;
+
+	// Se confirman los candidatos con una busqueda en anchura limitada al alcance que solo atraviesa casillas
+	// accesibles y sin elementos de la faccion actual. La busqueda termina al alcanzar todos los candidatos
+	const int32 CurrentFaction = GetCurrentFaction();
+
+	RangeWorkspace.Init(Grid.Num());
+	RangeWorkspace.NewSearch();
+	RangeWorkspace.SetNode(IndexIni, 0, -1);
+
+	// Se marcan los candidatos para comprobarlos en tiempo constante durante la busqueda
+	if (RangeCandidates.Num() != Grid.Num()) RangeCandidates.Init(false, Grid.Num());
+	for (const int32 Index : Candidates) RangeCandidates[Index] = true;
+
+	TArray<int32> Frontier;
+	Frontier.Add(IndexIni);
+
+	int32 NumPending = Candidates.Num();
+	for (int32 Head = 0; Head < Frontier.Num() && NumPending > 0; ++Head)
 	{
-		// Se obtienen los vecinos de la casilla actual y se procesan
-		TArray<FIntPoint> Neighbors = ULibraryTileMap::GetNeighbors(Pos2D, FIntPoint(Rows, Cols));
-		for (const FIntPoint Neighbor : Neighbors)
+		const int32 CurrentIndex = Frontier[Head];
+		const int32 CurrentCost = RangeWorkspace.Cost[CurrentIndex];
+		if (CurrentCost >= Range) continue;
+
+		Grid.ForEachNeighbor(CurrentIndex, [&](const int32 Index)
 		{
-			// Se obtiene el indice y se verifica que es valido, en caso contrario, se omite el vecino
-			const int32 Index = GetPositionInArray(Neighbor);
-			if (Index == -1 || !Tiles[Index]) continue;
+			if (RangeWorkspace.IsVisited(Index) || !Grid.IsAccesible(Index)) return;
+			if (CurrentFaction != -1 && Grid.HasElement(Index) && Grid.GetElementOwner(Index) == CurrentFaction) return;
+
+			RangeWorkspace.SetNode(Index, CurrentCost + 1, CurrentIndex);
+			Frontier.Add(Index);
+
+			if (RangeCandidates[Index])
+			{
+				OutElements.Add(GetCoordsInMap(Index));
+				--NumPending;
+			}
+		});
+	}
+
+	// Se desmarcan los candidatos para la siguiente consulta
+	for (const int32 Index : Candidates) RangeCandidates[Index] = false;
+}
+
+void AActorTileMap::ForEachTileWithinRange(const FIntPoint& Pos2D, const int32 Range, const bool CheckTileCost,
+                                           const bool CheckTileAccesibility,
+                                           const TFunctionRef<void(const FIntPoint& Pos, int32 Cost)> Function)
+{
+	// Si no se tiene alcance o la posicion no es valida, no se realiza ningun procesamiento
+	const int32 IndexIni = GetPositionInArray(Pos2D);
+	if (Range <= 0 || IndexIni == -1) return;
+
+	// Se obtiene la faccion actual para descartar las casillas con elementos propios
+	const int32 CurrentFaction = GetCurrentFaction();
+
+	// Se prepara el espacio de trabajo de la busqueda
+	RangeWorkspace.Init(Grid.Num());
+	RangeWorkspace.NewSearch();
+	RangeWorkspace.SetNode(IndexIni, 0, -1);
+
+	// Se crea la lista con prioridad ordenada por el coste de llegar a cada casilla
+	TPriorityQueue<FPathData> Frontier;
+	Frontier.Push(FPathData(Pos2D, 0));
+
+	while (!Frontier.IsEmpty())
+	{
+		// Se obtiene la casilla con menor coste y se descarta si la entrada ha quedado obsoleta
+		const FPathData CurrentData = Frontier.Pop();
+		const int32 CurrentIndex = GetPositionInArray(CurrentData.Pos2D);
+		const int32 CurrentCost = RangeWorkspace.Cost[CurrentIndex];
+		if (CurrentData.Priority > CurrentCost) continue;
 
-			// Se obtiene la casilla
-			const AActorTile* Tile = Tiles[Index];
+		// Se aplica la funcion sobre la casilla, a excepcion de la casilla de origen
+		if (CurrentIndex != IndexIni) Function(CurrentData.Pos2D, CurrentCost);
 
-			// Se obtiene el coste de acceder al vecino y se comprueba que se tenga alcance y que sea accesible
-			const int32 Cost = CheckTileCost ? Tile->GetMovementCost() : 1;
-			if (Cost <= Range && (!CheckTileAccesibility || Tile->IsAccesible()))
+		// Se procesan los vecinos de la casilla actual
+		Grid.ForEachNeighbor(CurrentIndex, [&](const int32 Index)
+		{
+			// Se obtiene el coste de acceder al vecino y se comprueba que sea transitable y se tenga alcance
+			const int32 Cost = CheckTileCost ? Grid.Costs[Index] : 1;
+			if (Cost < 0 || CurrentCost + Cost > Range) return;
+
+			// Se comprueba que sea accesible y que no contenga un elemento propiedad de la faccion actual
+			if (CheckTileAccesibility)
 			{
-				// Se trata de obtener el elemento de la casilla y se comprueba si es propiedad de la faccion actual
-				const AActorDamageableElement* Element = Tile->GetElement();
-				if (!CheckTileAccesibility || !Element || !Element->IsMine())
+				if (!Grid.IsAccesible(Index)) return;
+				if (CurrentFaction != -1 && Grid.HasElement(Index) && Grid.GetElementOwner(Index) == CurrentFaction)
 				{
-					// Si es accesible, se anade a la lista y se obtienen todos sus vecinos que sean alcanzables
-					InRange.Add(Neighbor);
-					InRange.Append(GetTilesWithinRange(Neighbor, Range - Cost, CheckTileCost, CheckTileAccesibility));
+					return;
 				}
 			}
-		}
+
+			// Si el nodo no se habia alcanzado o el nuevo coste es menor, se actualiza
+			const int32 NewCost = CurrentCost + Cost;
+			if (NewCost < RangeWorkspace.GetCost(Index))
+			{
+				RangeWorkspace.SetNode(Index, NewCost, CurrentIndex);
+				Frontier.Push(FPathData(GetCoordsInMap(Index), NewCost));
+			}
+		});
 	}
+}
+
+void AActorTileMap::GetReachableTiles(const FIntPoint& Pos2D, const int32 Range, const bool CheckTileCost,
+                                      const bool CheckTileAccesibility, TArray<FMovement>& InRange)
+{
+	InRange.Reset();
+	ForEachTileWithinRange(Pos2D, Range, CheckTileCost, CheckTileAccesibility,
+	                       [this, &InRange](const FIntPoint& Pos, const int32 Cost)
+	                       {
+		                       InRange.Add(FMovement(Pos, Grid.Costs[GetPositionInArray(Pos)], Cost));
+	                       });
+}
+
+TArray<FIntPoint> AActorTileMap::GetTilesWithinRange(const FIntPoint& Pos2D, const int32 Range,
+                                                     const bool CheckTileCost, const bool CheckTileAccesibility)
+{
+	// Se inicializa la lista de casillas alcanzables
+	TArray<FIntPoint> InRange = TArray<FIntPoint>();
+
+	// Se anaden todas las casillas alcanzables, cada una de ellas una unica vez
+	ForEachTileWithinRange(Pos2D, Range, CheckTileCost, CheckTileAccesibility,
+	                       [&InRange](const FIntPoint& Pos, int32) { InRange.Add(Pos); });
 
 	return InRange;
 }
 
+int32 AActorTileMap::GetClosestSettlementDistance(const FIntPoint& Pos, const int32 Faction) const
+{
+	const FSettlementDistanceField* Field = SettlementFields.Find(Faction);
+	return Field ? Field->GetDistance(GetPositionInArray(Pos)) : MAX_int32;
+}
+
+AActorSettlement* AActorTileMap::GetClosestSettlement(const FIntPoint& Pos, const int32 Faction) const
+{
+	// Se obtiene la posicion del asentamiento mas cercano y el asentamiento que la ocupa
+	const FSettlementDistanceField* Field = SettlementFields.Find(Faction);
+	const int32 Index = Field ? Field->GetClosest(GetPositionInArray(Pos)) : -1;
+
+	return Index != -1 && HasTile(Index) ? Tiles[Index]->GetInfo().Elements.Settlement : nullptr;
+}
+
 bool AActorTileMap::CanSetSettlementAtPos(const FIntPoint& Pos, const TArray<FIntPoint>& AdditionalSettlements) const
 {
 	// Se verifica que la casilla sea valida
 	const int32 Index = GetPositionInArray(Pos);
-	if (Index == -1 || !Tiles[Index]) return false;
+	if (Index == -1) return false;
 
-	// Si la casilla no es accesible o no es valida, no se puede establecer un asentamiento
-	if (!IsTileAccesible(Pos)) return false;
+	// Si la casilla no es accesible, no se puede establecer un asentamiento
+	if (!Grid.IsAccesible(Index)) return false;
 
 	// Si en la casilla hay un recurso, no se puede establecer un asentamiento
-	if (Tiles[Index]->HasResource()) return false;
+	if (Grid.HasResource(Index)) return false;
 
-	// Se procesan todos los asentamientos
-	for (const auto SettlementPos : SettlementsPos)
+	// Se recorren las casillas a distancia menor o igual que 3 y, si alguna contiene un asentamiento, no se puede
+	// establecer el asentamiento
+	bool SettlementTooClose = false;
+	ULibraryTileMap::ForEachTileInSpiral(Pos, 3, FIntPoint(Rows, Cols), [&](const FIntPoint& TilePos, int32)
 	{
-		// Si alguno de los asentamientos esta demasiado cerca, no se puede establecer el asentamiento
-		if (ULibraryTileMap::GetDistanceToElement(SettlementPos, Pos) <= 3) return false;
-	}
+		const int32 TileIndex = GetPositionInArray(TilePos);
+		SettlementTooClose |= TileIndex != -1 && Grid.HasSettlement(TileIndex);
+	});
+
+	if (SettlementTooClose) return false;
 
 	// Se procesan los asentamientos adicionales
 	for (const auto SettlementPos : AdditionalSettlements)
@@ -1209,142 +1510,423 @@ bool AActorTileMap::CanSetSettlementAtPos(const FIntPoint& Pos, const TArray<FIn
 
 //--------------------------------------------------------------------------------------------------------------------//
 
-const TArray<FMovement>& AActorTileMap::FindPath(const FIntPoint& PosIni, const FIntPoint& PosEnd,
-                                                 const EUnitType UnitType, const int32 BaseMovementPoints,
-                                                 int32 MovementPoints)
+FTileGridSnapshot AActorTileMap::CreateGridSnapshot() const
+{
+	// Solo se copia la rejilla si ha cambiado desde la ultima copia
+	if (!GridSnapshot.IsValid() || GridSnapshotVersion != MapVersion)
+	{
+		GridSnapshot = MakeShared<const FTileGrid, ESPMode::ThreadSafe>(Grid);
+		GridSnapshotVersion = MapVersion;
+	}
+
+	return GridSnapshot.ToSharedRef();
+}
+
+bool AActorTileMap::MakePathQuery(const FIntPoint& PosIni, const FIntPoint& PosEnd, const EUnitType UnitType,
+                                  const int32 BaseMovementPoints, const int32 MovementPoints,
+                                  FPathQuery& OutQuery) const
+{
+	// Se comprueba que los datos son correctos
+	const int32 IndexIni = GetPositionInArray(PosIni);
+	const int32 IndexEnd = GetPositionInArray(PosEnd);
+	if (IndexIni == -1 || IndexEnd == -1 || IndexIni == IndexEnd) return false;
+	if (!IsValidPathRequest(IndexIni, IndexEnd, UnitType)) return false;
+
+	// Se determina una unica vez la faccion actual y si el elemento del destino es enemigo
+	OutQuery = FPathQuery(IndexIni, IndexEnd, GetCurrentFaction(), IsTileElementEnemy(IndexEnd), BaseMovementPoints,
+	                      MovementPoints);
+	return true;
+}
+
+bool AActorTileMap::ComputePath(const FIntPoint& PosIni, const FIntPoint& PosEnd, const EUnitType UnitType,
+                                const int32 BaseMovementPoints, const int32 MovementPoints, TArray<FMovement>& OutPath,
+                                const EPathSearchMode SearchMode) const
 {
-	// Se limpian los datos anteriores
-	Path.Empty();
-	TotalCost.Empty();
+	OutPath.Reset();
 
+	FPathQuery Query;
+	if (!MakePathQuery(PosIni, PosEnd, UnitType, BaseMovementPoints, MovementPoints, Query)) return false;
+
+	// Si se fuerza un modo de busqueda, se calcula siempre el camino
+	if (SearchMode == EPathSearchMode::MinTurns)
+	{
+		const bool Found = FPathFinder::ComputePathByTurns(Grid, Query, TurnPathWorkspace, OutPath);
+		LastPathSearchExpanded = TurnPathWorkspace.NumExpanded;
+		return Found;
+	}
+
+	if (SearchMode != EPathSearchMode::Auto)
+	{
+		const bool Found = FPathFinder::ComputePath(Grid, Query, PathWorkspace, OutPath, SearchMode);
+		LastPathSearchExpanded = PathWorkspace.NumExpanded;
+		return Found;
+	}
+
+	// Si el camino ya se ha calculado sobre la version actual del mapa, se evita la busqueda
+	if (FindCachedPath(Query, OutPath)) return OutPath.Num() > 0;
+
+	FPathFinder::ComputePath(Grid, Query, PathWorkspace, OutPath);
+	LastPathSearchExpanded = PathWorkspace.NumExpanded;
+	AddCachedPath(Query, OutPath);
+
+	return OutPath.Num() > 0;
+}
+
+bool AActorTileMap::GetTileChangesSince(const uint32 Version, TArray<int32>& OutChanges) const
+{
+	OutChanges.Reset();
+	if (Version < FirstTileChangeVersion || Version > MapVersion) return false;
+
+	const int32 FirstChange = static_cast<int32>(Version - FirstTileChangeVersion);
+	OutChanges.Append(TileChanges.GetData() + FirstChange, static_cast<int32>(MapVersion - Version));
+	return true;
+}
+
+void AActorTileMap::GetPathCacheStats(int32& Hits, int32& Misses) const
+{
+	Hits = PathCacheHits;
+	Misses = PathCacheMisses;
+}
+
+void AActorTileMap::ResetPathCacheStats()
+{
+	PathCacheHits = 0;
+	PathCacheMisses = 0;
+}
+
+bool AActorTileMap::RepairPath(FPathReplanner& Replanner, const FIntPoint& PosIni, const FIntPoint& PosEnd,
+                               const EUnitType UnitType, const int32 BaseMovementPoints, const int32 MovementPoints,
+                               TArray<FMovement>& OutPath) const
+{
+	OutPath.Reset();
+
+	// Si la peticion no es valida, se liberan los datos de la busqueda
+	FPathQuery Query;
+	if (!MakePathQuery(PosIni, PosEnd, UnitType, BaseMovementPoints, MovementPoints, Query))
+	{
+		Replanner.Reset();
+		return false;
+	}
+
+	// Se notifican las casillas modificadas desde la ultima reparacion o, si no es posible, se reinicia la busqueda
+	TArray<int32> Changes;
+	if (Replanner.CanRepair(Grid, Query) && GetTileChangesSince(Replanner.GetMapVersion(), Changes))
+	{
+		for (const int32 Index : Changes) Replanner.NotifyTileChanged(Grid, Index);
+	}
+	else
+	{
+		Replanner.Init(Grid, Query, MapVersion);
+	}
+
+	if (!Replanner.Replan(Grid, Query.IndexIni, MapVersion, OutPath)) return false;
+
+	// Se actualiza el numero de turnos en alcanzar cada casilla del camino
+	ULibraryTileMap::UpdatePathTurns(OutPath, BaseMovementPoints, MovementPoints);
+
+	return true;
+}
+
+bool AActorTileMap::UpdateReachabilityMap(FReachabilityMap& Map, const FIntPoint& Pos, const int32 BaseMovementPoints,
+                                          const int32 MovementPoints, const int32 MaxTurns) const
+{
+	// Si la posicion no es valida, se invalida el mapa
+	const int32 IndexIni = GetPositionInArray(Pos);
+	if (IndexIni == -1)
+	{
+		Map.Reset();
+		return false;
+	}
+
+	// Si el mapa sigue siendo valido, se evita la busqueda
+	const int32 Faction = GetCurrentFaction();
+	if (Map.IsValidFor(IndexIni, Faction, BaseMovementPoints, MovementPoints, MaxTurns, MapVersion)) return false;
+
+	FPathFinder::ComputeReachability(Grid, IndexIni, Faction, BaseMovementPoints, MovementPoints, MaxTurns,
+	                                 TurnPathWorkspace, Map);
+	Map.MapVersion = MapVersion;
+
+	return true;
+}
+
+TArray<FMovement> AActorTileMap::FindPath(const FIntPoint& PosIni, const FIntPoint& PosEnd, const EUnitType UnitType,
+                                          const int32 BaseMovementPoints, const int32 MovementPoints,
+                                          const bool MinimizeTurns)
+{
 	// Se llama al evento para que todos los suscriptores realicen las operaciones definidas
 	OnPathCreated.Broadcast(TArray<FMovement>());
+	TotalCost.Reset();
 
-	// Si las dos casillas son iguales, se devuelve un array vacio
-	if (PosIni == PosEnd) return Path;
-
-	// Se comprueba que los datos son correctos, si no lo son, se devuelve un array vacio
-	if (!(GetPositionInArray(PosIni) != -1 && GetPositionInArray(PosEnd) != -1))
+	// Se calcula el camino, empleando la cache salvo que se pidan menos turnos. Si no existe se devuelve un array vacio
+	const EPathSearchMode SearchMode = MinimizeTurns ? EPathSearchMode::MinTurns : EPathSearchMode::Auto;
+	if (!ComputePath(PosIni, PosEnd, UnitType, BaseMovementPoints, MovementPoints, Path, SearchMode))
 	{
 		return Path;
 	}
 
-	// Se comprueba que las casillas sean accesibles, si no lo son, se devuelve un array vacio
-	if (!(Tiles[GetPositionInArray(PosIni)]->IsAccesible() && Tiles[GetPositionInArray(PosEnd)]->IsAccesible()))
+	// Se actualiza el coste de llegar a cada casilla del camino
+	TotalCost.Reserve(Path.Num() + 1);
+	TotalCost.Add(PosIni, 0);
+	for (const FMovement& Movement : Path) TotalCost.Add(Movement.Pos2D, Movement.TotalCost);
+
+	// Se recorren todos los elementos del camino para llamar al evento que actualiza la visual del mapa
+	for (int32 i = 0; i < Path.Num(); ++i)
 	{
-		return Path;
+		// Se llama al evento para que todos los suscriptores realicen las operaciones definidas
+		OnPathUpdated.Broadcast(Path[i].Pos2D, Path);
 	}
 
-	// Se comprueba que no haya una unidad en la casilla de destino, si la hay se devuelve un array vacio
-	if (UnitType == EUnitType::Civil && Tiles[GetPositionInArray(PosEnd)]->HasUnit()) return Path;
+	return Path;
+}
 
-	// Se crea una lista con prioridad para almacenar los nodos por visitar ordenados de mayor a menor prioridad
-	// teniendo en cuenta que la prioridad se basa en la cercania al objetivo y el coste
-	//
-	// Inicialmente, se inserta el nodo inicial
-	TPriorityQueue<FPathData> Frontier;
-	Frontier.Push(FPathData(PosIni, 0));
+void AActorTileMap::FindPaths(const TArray<FPathRequest>& Requests, TArray<TArray<FMovement>>& OutPaths,
+                              const bool RunInParallel) const
+{
+	OutPaths.Reset();
+	OutPaths.SetNum(Requests.Num());
 
-	// Se crea un diccionario que almacena, para cada nodo, desde cual se ha llegado a el
-	TMap<FIntPoint, FIntPoint> CameFrom;
-	CameFrom.Add(PosIni, FIntPoint(-1, -1));
+	// Se crean las consultas de las peticiones validas. Los datos que dependen de los actores se obtienen aqui, en el
+	// hilo principal, para que el calculo solo lea la rejilla de casillas
+	TArray<FPathQuery> Queries;
+	Queries.SetNum(Requests.Num());
 
-	// Se inicializa el diccionario de costes
-	TotalCost.Add(PosIni, 0);
+	// Las peticiones cuyo camino ya esta almacenado se resuelven directamente, el resto se agrupan por destino
+	TMap<int32, TArray<int32>> RequestsByGoal;
+	for (int32 i = 0; i < Requests.Num(); ++i)
+	{
+		const FPathRequest& Request = Requests[i];
+		if (!MakePathQuery(Request.PosIni, Request.PosEnd, Request.UnitType, Request.BaseMovementPoints,
+		                   Request.MovementPoints, Queries[i]))
+		{
+			continue;
+		}
 
-	// Se procesan nodos mientras sigan quedando
-	while (!Frontier.IsEmpty())
+		if (!FindCachedPath(Queries[i], OutPaths[i])) RequestsByGoal.FindOrAdd(Queries[i].IndexEnd).Add(i);
+	}
+
+	TArray<int32> Goals;
+	RequestsByGoal.GenerateKeyArray(Goals);
+
+	// Se calculan los caminos de cada grupo de peticiones con el mismo destino
+	auto ProcessGoal = [&](const int32 GoalIndex, FPathWorkspace& Workspace)
 	{
-		// Se obtiene el nodo con la mayor prioridad y se comprueba si se ha llegado al destino
-		const FPathData CurrentData = Frontier.Pop();
-		if (CurrentData.Pos2D == PosEnd)
+		const int32 IndexEnd = Goals[GoalIndex];
+		const TArray<int32>& GoalRequests = RequestsByGoal.FindChecked(IndexEnd);
+
+		// Si solo hay una peticion, se emplea la busqueda A*
+		if (GoalRequests.Num() == 1)
 		{
-			// Se procesan todos los nodos del diccionario CameFrom que nos permite conocer el camino de vuelta
-			// a la posicion inicial desde el objetivo
-			FIntPoint Current = CurrentData.Pos2D;
+			FPathFinder::ComputePath(Grid, Queries[GoalRequests[0]], Workspace, OutPaths[GoalRequests[0]]);
+			return;
+		}
 
-			while (Current != PosIni)
-			{
-				const int32 Index = GetPositionInArray(Current);
-				if (Index == -1 || !Tiles[Index]) break;
+		// En caso contrario, se realiza una unica busqueda inversa desde el destino
+		const FPathQuery& GoalQuery = Queries[GoalRequests[0]];
+		TArray<int32> Starts;
+		for (const int32 RequestIndex : GoalRequests) Starts.Add(Queries[RequestIndex].IndexIni);
 
-				// Se obtiene el coste de movimiento de la casilla actual
-				const int32 CurrentCost = Tiles[Index]->GetMovementCost();
+		FPathFinder::SearchPathsToGoal(Grid, Starts, IndexEnd, GoalQuery.Faction, GoalQuery.IsGoalEnemy, Workspace);
 
-				// Se anade el nodo actual al camino a devolver
-				Path.Insert(FMovement(Current, CurrentCost, TotalCost[Current]), 0);
+		// Se obtiene el camino de cada peticion siguiendo la procedencia hasta el destino
+		for (int32 i = 0; i < GoalRequests.Num(); ++i)
+		{
+			if (!Workspace.IsVisited(Starts[i])) continue;
 
-				// Se actualiza al siguiente nodo
-				Current = CameFrom[Current];
-			}
+			const FPathQuery& Query = Queries[GoalRequests[i]];
+			TArray<FMovement>& RequestPath = OutPaths[GoalRequests[i]];
 
-			// Se recorren todos los elementos del camino para llamar al evento que actualiza la visual del mapa
-			for (int32 i = 0; i < Path.Num(); ++i)
+			const int32 StartCost = Workspace.Cost[Starts[i]];
+			for (int32 Index = Workspace.Parent[Starts[i]]; Index != -1; Index = Workspace.Parent[Index])
 			{
-				// Se actualiza el numero de turnos en alcanzar la casilla actual
-				ULibraryTileMap::GetPathTurnAtIndex(Path, i, BaseMovementPoints, MovementPoints);
-
-				// Se llama al evento para que todos los suscriptores realicen las operaciones definidas
-				OnPathUpdated.Broadcast(Path[i].Pos2D, Path);
+				RequestPath.Add(FMovement(Grid.GetPos(Index), Grid.Costs[Index], StartCost - Workspace.Cost[Index]));
 			}
 
-			break;
+			ULibraryTileMap::UpdatePathTurns(RequestPath, Query.BaseMovementPoints, Query.MovementPoints);
 		}
+	};
 
-		// Se calculan los vecinos de la casilla actual y se procesan
-		const FIntPoint Limit = FIntPoint(Rows, Cols);
-		for (const FIntPoint NeighborPos : ULibraryTileMap::GetNeighbors(CurrentData.Pos2D, Limit))
+	if (RunInParallel && Goals.Num() > 1)
+	{
+		// Se lanza una tarea por hilo disponible y cada una reutiliza su espacio de trabajo entre llamadas. Las tareas
+		// toman los destinos pendientes de un contador compartido, la rejilla de casillas solo se lee
+		const int32 NumTasks = FMath::Min(Goals.Num(), FTaskGraphInterface::Get().GetNumWorkerThreads() + 1);
+		if (ParallelPathWorkspaces.Num() < NumTasks) ParallelPathWorkspaces.SetNum(NumTasks);
+
+		FThreadSafeCounter NextGoal;
+		ParallelFor(NumTasks, [&](const int32 Task)
 		{
-			// Si el indice no es valido, se salta el vecino actual
-			const int32 Index = GetPositionInArray(NeighborPos);
-			if (Index == -1 || !Tiles[Index]) continue;
+			FPathWorkspace& Workspace = ParallelPathWorkspaces[Task];
+			int32 GoalIndex;
+			while ((GoalIndex = NextGoal.Increment() - 1) < Goals.Num()) ProcessGoal(GoalIndex, Workspace);
+		});
+	}
+	else
+	{
+		for (int32 GoalIndex = 0; GoalIndex < Goals.Num(); ++GoalIndex) ProcessGoal(GoalIndex, PathWorkspace);
+	}
 
-			// Se verifica si el vecino calculado es correcto y, en caso de ser accesible, se obtiene
-			const AActorTile* NeighborTile;
-			if ((NeighborTile = Tiles[Index])->IsAccesible())
-			{
-				// Se trata de obtener el elemento de la casilla actual y, si lo tiene, solo se acepta si
-				//		* es un asentamiento propio
-				//		* se encuentra en la casilla de destino y es propiedad de una faccion enemiga (en guerra)
-				const AActorDamageableElement* Element = NeighborTile->GetElement();
-				if (!Element || (Cast<AActorSettlement>(Element) && Element->IsMine()) ||
-					(NeighborTile->GetPos() == PosEnd && Element->IsEnemy()))
-				{
-					// Se calcula el coste de llegar a esta casilla junto con el coste de movimiento de la propia casilla
-					int32 NewCost = TotalCost[CurrentData.Pos2D] + NeighborTile->GetMovementCost();
-					if (!TotalCost.Contains(NeighborPos))
-					{
-						// Si el nodo no se habia procesado previamente, se anade a las diferentes estructuras
-						// con los valores de prioridad y coste correctos
-						TotalCost.Add(NeighborPos, NewCost);
+	// Se almacenan los caminos calculados, de nuevo en el hilo principal
+	for (const auto& GoalRequests : RequestsByGoal)
+	{
+		for (const int32 Index : GoalRequests.Value) AddCachedPath(Queries[Index], OutPaths[Index]);
+	}
+}
 
-						const int32 Priority = NewCost + ULibraryTileMap::GetDistanceToElement(
-							NeighborTile->GetPos(), PosEnd);
-						Frontier.Push(FPathData(NeighborPos, Priority));
+bool AActorTileMap::FindCachedPath(const FPathQuery& Query, TArray<FMovement>& OutPath) const
+{
+	// Si el mapa ha cambiado, los caminos almacenados ya no son validos
+	if (PathCacheVersion != MapVersion)
+	{
+		PathCache.Empty(PathCacheSize);
+		PathCacheVersion = MapVersion;
+	}
 
-						CameFrom.Add(NeighborPos, CurrentData.Pos2D);
-					}
-					else
-					{
-						// Si el nodo se habia procesado previamente, se obtiene una referencia a su coste y, en caso
-						// de ser mayor al nuevo coste calculado, se actualizan todos los valores de las diferentes
-						// estructuras
-						int32& CurrentCost = TotalCost[NeighborPos];
-						if (NewCost < CurrentCost)
-						{
-							CurrentCost = NewCost;
-
-							const int32 Priority = NewCost + ULibraryTileMap::GetDistanceToElement(
-								NeighborTile->GetPos(), PosEnd);
-							Frontier.Push(FPathData(NeighborPos, Priority));
-
-							CameFrom[NeighborPos] = CurrentData.Pos2D;
-						}
-					}
-				}
+	const TArray<FMovement>* CachedPath = PathCache.FindAndTouch(Query);
+	if (!CachedPath)
+	{
+		++PathCacheMisses;
+		return false;
+	}
+
+	++PathCacheHits;
+	OutPath = *CachedPath;
+	return true;
+}
+
+void AActorTileMap::AddCachedPath(const FPathQuery& Query, const TArray<FMovement>& CachedPath) const
+{
+	if (PathCacheVersion == MapVersion) PathCache.Add(Query, CachedPath);
+}
+
+bool AActorTileMap::IsTileElementEnemy(const int32 Index) const
+{
+	const AActorDamageableElement* Element = Tiles.IsValidIndex(Index) && Tiles[Index]
+		                                         ? Tiles[Index]->GetElement()
+		                                         : nullptr;
+	return Element && Element->IsEnemy();
+}
+
+bool AActorTileMap::IsValidPathRequest(const int32 IndexIni, const int32 IndexEnd, const EUnitType UnitType) const
+{
+	// Se comprueba que las casillas sean accesibles y esten conectadas
+	if (!(Grid.IsAccesible(IndexIni) && Grid.IsAccesible(IndexEnd))) return false;
+	if (!Grid.AreConnected(IndexIni, IndexEnd)) return false;
+
+	// Se comprueba que no haya una unidad en la casilla de destino si la unidad es civil
+	return !(UnitType == EUnitType::Civil && Grid.HasUnit(IndexEnd));
+}
+
+TArray<FMovement> AActorTileMap::FindLongRangePath(const FIntPoint& PosIni, const FIntPoint& PosEnd,
+                                                   const EUnitType UnitType, const int32 BaseMovementPoints,
+                                                   const int32 MovementPoints, const int32 RefinedTurns)
+{
+	TArray<FMovement> LongPath;
+
+	// Si el destino esta cerca o no es alcanzable, se emplea la busqueda sobre todo el mapa
+	const int32 IndexIni = Grid.GetIndex(PosIni);
+	const int32 IndexEnd = Grid.GetIndex(PosEnd);
+	if (IndexIni == -1 || IndexEnd == -1 || !Grid.AreConnected(IndexIni, IndexEnd) ||
+		ULibraryTileMap::GetDistanceToElement(PosIni, PosEnd) < 2 * FHexClusterGraph::ClusterSize)
+	{
+		ComputePath(PosIni, PosEnd, UnitType, BaseMovementPoints, MovementPoints, LongPath);
+		return LongPath;
+	}
+
+	// Se obtiene el camino aproximado sobre el grafo de clusters
+	TArray<int32> AbstractPath;
+	if (!ClusterGraph.FindPath(Grid, IndexIni, IndexEnd, AbstractPath))
+	{
+		ComputePath(PosIni, PosEnd, UnitType, BaseMovementPoints, MovementPoints, LongPath);
+		return LongPath;
+	}
+
+	// Se obtiene la ultima casilla del camino que se alcanza en los turnos que se van a refinar
+	int32 Last = -1;
+	for (int32 i = 0, Turn = 1, Points = MovementPoints; i < AbstractPath.Num(); ++i)
+	{
+		const int32 Cost = Grid.Costs[AbstractPath[i]];
+		if (Cost > Points)
+		{
+			if (++Turn > RefinedTurns) break;
+			Points = BaseMovementPoints;
+		}
+
+		Points -= Cost;
+		Last = i;
+	}
+
+	// La casilla final del tramo refinado no puede contener ningun elemento
+	while (Last >= 0 && Grid.HasElement(AbstractPath[Last])) --Last;
+
+	// Si el tramo refinado es todo el camino o no existe, o no se puede calcular el camino exacto del tramo
+	// refinado, se emplea la busqueda sobre todo el mapa
+	if (Last < 0 || Last == AbstractPath.Num() - 1 ||
+		!ComputePath(PosIni, GetCoordsInMap(AbstractPath[Last]), UnitType, BaseMovementPoints, MovementPoints,
+		             LongPath))
+	{
+		ComputePath(PosIni, PosEnd, UnitType, BaseMovementPoints, MovementPoints, LongPath);
+		return LongPath;
+	}
+
+	// Se completa el camino con el resto del camino aproximado
+	int32 PathCost = LongPath.Last().TotalCost;
+	for (int32 i = Last + 1; i < AbstractPath.Num(); ++i)
+	{
+		const int32 Index = AbstractPath[i];
+		PathCost += Grid.Costs[Index];
+		LongPath.Add(FMovement(GetCoordsInMap(Index), Grid.Costs[Index], PathCost));
+	}
+
+	// Se actualiza el numero de turnos en alcanzar cada casilla del camino
+	ULibraryTileMap::UpdatePathTurns(LongPath, BaseMovementPoints, MovementPoints);
+
+	return LongPath;
+}
+
+void AActorTileMap::BuildFlowField(const TArray<FIntPoint>& Targets, const bool TargetsAreEnemies,
+                                   FFlowField& OutField) const
+{
+	// Se obtienen las posiciones en el Array1D de los objetivos
+	TArray<int32> TargetIndices;
+	TargetIndices.Reserve(Targets.Num());
+	for (const FIntPoint& Target : Targets) TargetIndices.Add(Grid.GetIndex(Target));
+
+	FPathFinder::BuildFlowField(Grid, TargetIndices, GetCurrentFaction(), TargetsAreEnemies, OutField);
+}
+
+bool AActorTileMap::GetFlowFieldPath(const FFlowField& Field, const FIntPoint& Pos, const int32 BaseMovementPoints,
+                                     const int32 MovementPoints, TArray<FMovement>& OutPath) const
+{
+	OutPath.Reset();
+
+	// Se verifica que el campo corresponda al mapa actual y que se pueda alcanzar algun objetivo
+	const int32 IndexIni = Grid.GetIndex(Pos);
+	if (IndexIni == -1 || Field.Num() != Grid.Num() || !Field.IsReachable(IndexIni)) return false;
+
+	// Se sigue la siguiente casilla de cada casilla hasta llegar al objetivo
+	int32 PathCost = 0;
+	for (int32 Index = Field.Next[IndexIni]; Index != -1; Index = Field.Next[Index])
+	{
+		// Si la casilla esta ocupada, solo es valida si es el objetivo y contiene un elemento de otra faccion
+		if (Grid.HasElement(Index))
+		{
+			const bool IsTarget = Field.Targets[Index] == Index;
+			const bool IsValid = IsTarget
+				                     ? Field.TargetsAreEnemies && Grid.GetElementOwner(Index) != Field.Faction
+				                     : FPathFinder::CanEnterTile(Grid, Index, -1, Field.Faction, false);
+			if (!IsValid)
+			{
+				OutPath.Reset();
+				return false;
 			}
 		}
+
+		PathCost += Grid.Costs[Index];
+		OutPath.Add(FMovement(GetCoordsInMap(Index), Grid.Costs[Index], PathCost));
 	}
 
-	return Path;
+	// Se actualiza el numero de turnos en alcanzar cada casilla del camino
+	ULibraryTileMap::UpdatePathTurns(OutPath, BaseMovementPoints, MovementPoints);
+
+	return OutPath.Num() > 0;
 }
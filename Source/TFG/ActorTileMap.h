@@ -3,8 +3,19 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "FFlowField.h"
+#include "FHexClusterGraph.h"
 #include "FMovement.h"
+#include "FOccupancyIndex.h"
+#include "FPathFinder.h"
+#include "FPathReplanner.h"
+#include "FPathRequest.h"
+#include "FReachabilityMap.h"
+#include "FSettlementDistanceField.h"
+#include "FPathWorkspace.h"
+#include "FTileGrid.h"
 #include "SaveMap.h"
+#include "Containers/LruCache.h"
 #include "GameFramework/Actor.h"
 #include "ActorTileMap.generated.h"
 
@@ -196,7 +207,9 @@ protected:
 	//----------------------------------------------------------------------------------------------------------------//
 
 	/**
-	 * Array con informacion sobre el posicionamiento de las casillas y su tipo. Se emplea en los archivos de guardado
+	 * Diccionario con informacion sobre el posicionamiento de las casillas y su tipo para los Blueprints, que ademas
+	 * modifican los estados. Desde C++ solo se escribe y, salvo los estados, la informacion se lee de los actores
+	 * del array Tiles, indexado por la posicion en el Array1D
 	 */
 	UPROPERTY(VisibleInstanceOnly, BlueprintReadWrite, Category="Map|Grid")
 	TMap<FIntPoint, FTileInfo> TilesInfo;
@@ -207,7 +220,8 @@ protected:
 	TArray<AActorTile*> Tiles;
 
 	/**
-	 * Diccionario que almacena, para cada estado, las casillas que lo tienen
+	 * Diccionario que almacena, para cada estado, las casillas que lo tienen. Lo modifica BP_TileMap al anadir y
+	 * eliminar estados de las casillas
 	 */
 	UPROPERTY(VisibleInstanceOnly, BlueprintReadWrite, Category="Map|Info")
 	TMap<ETileState, FTilesArray> TilesWithState;
@@ -300,17 +314,116 @@ protected:
 	//----------------------------------------------------------------------------------------------------------------//
 
 	/**
-	 * Almacen del camino a seguir
+	 * Estado de las casillas en arrays densos indexados por la posicion en el Array1D. Se mantiene sincronizado con
+	 * los actores de las casillas y es la fuente de verdad para las consultas del mapa
+	 */
+	FTileGrid Grid;
+
+	//----------------------------------------------------------------------------------------------------------------//
+
+	/**
+	 * Ultimo camino calculado con FindPath, que es el que se muestra en la interfaz
 	 */
 	UPROPERTY(VisibleInstanceOnly, BlueprintReadWrite, Category="Map|Pathfinding")
 	TArray<FMovement> Path;
 
 	/**
-	 * Diccionario que almacena, para cada nodo, el coste de llegar a el
+	 * Diccionario que almacena, para cada casilla del ultimo camino calculado con FindPath, el coste de llegar a ella.
+	 * Se rellena a partir del camino, ya que los costes de la busqueda se guardan en el espacio de trabajo
 	 */
 	UPROPERTY(VisibleInstanceOnly, BlueprintReadWrite, Category="Map|Pathfinding")
 	TMap<FIntPoint, int32> TotalCost;
 
+	/**
+	 * Espacio de trabajo reutilizable con los costes y la procedencia de cada casilla durante la busqueda de caminos.
+	 * Solo se emplea desde el hilo principal, las busquedas en otros hilos deben emplear su propio espacio de trabajo
+	 */
+	mutable FPathWorkspace PathWorkspace;
+
+	/**
+	 * Espacios de trabajo reutilizables de la busqueda de caminos en paralelo, uno por cada tarea que se lanza
+	 */
+	mutable TArray<FPathWorkspace> ParallelPathWorkspaces;
+
+	/**
+	 * Espacio de trabajo reutilizable de la busqueda de caminos por turnos
+	 */
+	mutable FTurnPathWorkspace TurnPathWorkspace;
+
+	/**
+	 * Numero de casillas expandidas en la ultima busqueda realizada con ComputePath
+	 */
+	mutable int32 LastPathSearchExpanded = 0;
+
+	/**
+	 * Espacio de trabajo reutilizable para las consultas de casillas al alcance
+	 */
+	mutable FPathWorkspace RangeWorkspace;
+
+	/**
+	 * Marcas de los candidatos de la consulta de casillas al alcance en curso. Se desmarcan al terminar la consulta
+	 */
+	mutable TBitArray<> RangeCandidates;
+
+	/**
+	 * Grafo de clusters del mapa empleado en la busqueda jerarquica de caminos largos
+	 */
+	FHexClusterGraph ClusterGraph;
+
+	/**
+	 * Version del mapa. Se incrementa cada vez que cambia una casilla de forma que pueda afectar a los caminos
+	 */
+	uint32 MapVersion = 0;
+
+	/**
+	 * Registro de las casillas modificadas para reparar los caminos de forma incremental. La entrada i corresponde a
+	 * la version FirstTileChangeVersion + i + 1
+	 */
+	TArray<int32> TileChanges;
+	uint32 FirstTileChangeVersion = 0;
+
+	/**
+	 * Numero maximo de cambios que se conservan en el registro. Las busquedas mas antiguas se recalculan por completo
+	 */
+	static constexpr int32 MaxTileChanges = 4096;
+
+	/**
+	 * Cache de los ultimos caminos calculados. Solo es valida para la version del mapa PathCacheVersion, por lo que
+	 * se vacia en cuanto el mapa cambia. Solo se emplea desde el hilo principal
+	 */
+	mutable TLruCache<FPathQuery, TArray<FMovement>> PathCache;
+	mutable uint32 PathCacheVersion = MAX_uint32;
+
+	/**
+	 * Numero de consultas resueltas con la cache y numero de consultas que han necesitado una busqueda
+	 */
+	mutable int32 PathCacheHits = 0;
+	mutable int32 PathCacheMisses = 0;
+
+	/**
+	 * Numero maximo de caminos almacenados en la cache
+	 */
+	static constexpr int32 PathCacheSize = 256;
+
+	/**
+	 * Distancia de cada casilla al asentamiento mas cercano de cada faccion. Se actualiza al anadir y eliminar
+	 * asentamientos del mapa
+	 */
+	TMap<int32, FSettlementDistanceField> SettlementFields;
+
+	/**
+	 * Indice de las facciones con unidades o asentamientos en cada zona del mapa. Se actualiza al anadir y eliminar
+	 * elementos de las casillas
+	 */
+	FOccupancyIndex Occupancy;
+
+	/**
+	 * Copia inmutable de la rejilla que comparten los analisis que se ejecutan fuera del hilo principal. Se reutiliza
+	 * mientras no cambie la version del mapa GridSnapshotVersion
+	 */
+	mutable TSharedPtr<const FTileGrid, ESPMode::ThreadSafe> GridSnapshot;
+	mutable uint32 GridSnapshotVersion = 0;
+
 public:
 	/**
 	 * Constructor de la clase que inicializa los parametros del actor
@@ -342,6 +455,91 @@ private:
 	 */
 	int32 GetColInMap(const int32 Pos1D) const { return Pos1D % Cols; }
 
+	/**
+	 * Metodo privado que verifica si existe el actor de la casilla en la posicion dada del Array1D
+	 * 
+	 * @param Pos1D Posicion en el Array1D
+	 * @return Si el array Tiles contiene una casilla valida en la posicion
+	 */
+	bool HasTile(const int32 Pos1D) const { return Tiles.IsValidIndex(Pos1D) && Tiles[Pos1D] != nullptr; }
+
+	/**
+	 * Metodo privado que aplica una modificacion a la entrada del diccionario TilesInfo de una casilla, para que los
+	 * Blueprints vean los cambios realizados desde C++
+	 * 
+	 * @param Pos Posicion en el Array2D
+	 * @param Function Funcion que modifica la informacion de la casilla
+	 */
+	template <typename FunctionType>
+	void UpdateTileInfo(const FIntPoint& Pos, FunctionType&& Function)
+	{
+		if (FTileInfo* TileInfo = TilesInfo.Find(Pos)) Function(*TileInfo);
+	}
+
+	//----------------------------------------------------------------------------------------------------------------//
+
+	/**
+	 * Metodo privado que obtiene el indice de la faccion que se encuentra en juego
+	 * 
+	 * @return Indice de la faccion actual o -1 si no se puede obtener
+	 */
+	int32 GetCurrentFaction() const;
+
+	/**
+	 * Metodo privado que verifica si el elemento de una casilla pertenece a una faccion enemiga de la faccion en juego.
+	 * Accede a los actores, por lo que debe llamarse desde el hilo principal
+	 * 
+	 * @param Index Posicion en el Array1D
+	 * @return Si la casilla contiene un elemento enemigo
+	 */
+	bool IsTileElementEnemy(const int32 Index) const;
+
+	/**
+	 * Metodo privado que verifica si se puede buscar un camino entre dos casillas: ambas deben ser accesibles, estar
+	 * conectadas y, si la unidad es civil, el destino no puede contener una unidad
+	 * 
+	 * @param IndexIni Posicion en el Array1D de la casilla inicial
+	 * @param IndexEnd Posicion en el Array1D de la casilla de destino
+	 * @param UnitType Tipo de unidad que se mueve
+	 * @return Si la peticion de camino es valida
+	 */
+	bool IsValidPathRequest(const int32 IndexIni, const int32 IndexEnd, const EUnitType UnitType) const;
+
+	/**
+	 * Metodo privado que registra el cambio de una casilla e incrementa la version del mapa
+	 * 
+	 * @param Index Posicion en el Array1D de la casilla modificada
+	 */
+	void RegisterTileChange(const int32 Index);
+
+	/**
+	 * Metodo privado que vacia el registro de cambios cuando se genera o carga un mapa nuevo
+	 */
+	void ResetTileChanges();
+
+	/**
+	 * Metodo privado que calcula desde cero la distancia al asentamiento mas cercano de cada faccion a partir de los
+	 * asentamientos de la rejilla
+	 */
+	void RebuildSettlementFields();
+
+	/**
+	 * Metodo privado que busca el camino de una consulta en la cache
+	 * 
+	 * @param Query Consulta de camino
+	 * @param OutPath Camino almacenado, vacio si no existe camino
+	 * @return Si la consulta se encontraba en la cache
+	 */
+	bool FindCachedPath(const FPathQuery& Query, TArray<FMovement>& OutPath) const;
+
+	/**
+	 * Metodo privado que almacena el camino de una consulta en la cache
+	 * 
+	 * @param Query Consulta de camino
+	 * @param CachedPath Camino calculado, vacio si no existe camino
+	 */
+	void AddCachedPath(const FPathQuery& Query, const TArray<FMovement>& CachedPath) const;
+
 	//----------------------------------------------------------------------------------------------------------------//
 
 	/**
@@ -467,6 +665,15 @@ protected:
 	UFUNCTION(BlueprintCallable, BlueprintPure=false)
 	AActorTile* GetTileAtPos(const FIntPoint& Pos) const;
 
+	/**
+	 * Metodo que devuelve la informacion de una casilla del mapa dada su posicion en el mismo
+	 * 
+	 * @param Pos Coordenadas en el Array2D
+	 * @return Informacion de la casilla o una informacion por defecto con posicion (-1, -1) si no existe
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure=false)
+	FTileInfo GetTileInfoAtPos(const FIntPoint& Pos) const;
+
 	/**
 	 * Metodo que obtiene la lista de casillas con un estado dado
 	 * 
@@ -476,6 +683,17 @@ protected:
 	UFUNCTION(BlueprintCallable, BlueprintPure=false)
 	TArray<FIntPoint> GetTilesWithState(const ETileState State) const;
 
+	/**
+	 * Metodo que verifica si dos casillas estan conectadas por casillas accesibles, es decir, si pertenecen a la
+	 * misma componente conexa del mapa. Permite descartar destinos inalcanzables en O(1)
+	 * 
+	 * @param PosA Posicion en el Array2D de la primera casilla
+	 * @param PosB Posicion en el Array2D de la segunda casilla
+	 * @return Si existe algun camino entre ambas casillas
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure=false)
+	bool AreTilesConnected(const FIntPoint& PosA, const FIntPoint& PosB) const;
+
 	//----------------------------------------------------------------------------------------------------------------//
 
 	/**
@@ -591,6 +809,15 @@ protected:
 	UFUNCTION(BlueprintCallable)
 	void RemoveSettlementFromTile(const FIntPoint& Pos);
 
+	/**
+	 * Metodo que actualiza la faccion propietaria de la unidad y el asentamiento de la casilla dada en las estructuras
+	 * del mapa. Debe llamarse cuando cambia la faccion de un elemento que ya esta situado en el mapa
+	 * 
+	 * @param Pos Posicion de la casilla
+	 */
+	UFUNCTION(BlueprintCallable)
+	void UpdateElementsOwner(const FIntPoint& Pos);
+
 	//----------------------------------------------------------------------------------------------------------------//
 
 	/**
@@ -675,6 +902,71 @@ public:
 	 */
 	const TSet<FIntPoint>& GetSettlementsPos() const { return SettlementsPos; }
 
+	/**
+	 * Metodo que obtiene la distancia de una casilla al asentamiento mas cercano de una faccion
+	 * 
+	 * @param Pos Posicion en el Array2D
+	 * @param Faction Faccion propietaria de los asentamientos
+	 * @return Distancia en casillas o MAX_int32 si la faccion no tiene asentamientos
+	 */
+	int32 GetClosestSettlementDistance(const FIntPoint& Pos, const int32 Faction) const;
+
+	/**
+	 * Metodo que obtiene el asentamiento de una faccion mas cercano a una casilla
+	 * 
+	 * @param Pos Posicion en el Array2D
+	 * @param Faction Faccion propietaria de los asentamientos
+	 * @return Asentamiento mas cercano o nullptr si la faccion no tiene asentamientos
+	 */
+	AActorSettlement* GetClosestSettlement(const FIntPoint& Pos, const int32 Faction) const;
+
+	/**
+	 * Getter del atributo Grid
+	 * 
+	 * @return Estado de las casillas del mapa en arrays densos
+	 */
+	const FTileGrid& GetGrid() const { return Grid; }
+
+	/**
+	 * Getter del atributo MapVersion
+	 * 
+	 * @return Version actual del mapa
+	 */
+	uint32 GetMapVersion() const { return MapVersion; }
+
+	/**
+	 * Metodo que obtiene las casillas modificadas desde una version del mapa
+	 * 
+	 * @param Version Version del mapa desde la que se obtienen los cambios
+	 * @param OutChanges Posiciones en el Array1D de las casillas modificadas, puede contener repetidas
+	 * @return Si el registro conserva todos los cambios desde la version dada
+	 */
+	bool GetTileChangesSince(const uint32 Version, TArray<int32>& OutChanges) const;
+
+	/**
+	 * Metodo que obtiene las estadisticas de la cache de caminos
+	 * 
+	 * @param Hits Numero de consultas resueltas con la cache
+	 * @param Misses Numero de consultas que han necesitado una busqueda
+	 */
+	UFUNCTION(BlueprintCallable, Category="Map|Pathfinding")
+	void GetPathCacheStats(int32& Hits, int32& Misses) const;
+
+	/**
+	 * Metodo que reinicia las estadisticas de la cache de caminos
+	 */
+	UFUNCTION(BlueprintCallable, Category="Map|Pathfinding")
+	void ResetPathCacheStats();
+
+	/**
+	 * Metodo que devuelve el numero de casillas expandidas en la ultima busqueda realizada con ComputePath. Permite
+	 * comparar los modos de busqueda sobre los mapas del juego
+	 * 
+	 * @return Numero de casillas expandidas
+	 */
+	UFUNCTION(BlueprintCallable, Category="Map|Pathfinding")
+	int32 GetLastPathSearchExpanded() const { return LastPathSearchExpanded; }
+
 	//----------------------------------------------------------------------------------------------------------------//
 
 	/**
@@ -744,14 +1036,56 @@ public:
 	 */
 	bool TileHasEnemyOrAlly(const FIntPoint& Pos2D, const bool CheckEnemy) const;
 
+	/**
+	 * Metodo que obtiene las casillas con elementos de facciones enemigas o aliadas a una distancia menor o igual que
+	 * la dada de una posicion. Solo se recorren las zonas del mapa con elementos de las facciones buscadas
+	 * 
+	 * @param Pos2D Coordenadas en el Array2D
+	 * @param Range Distancia maxima desde la posicion dada
+	 * @param CheckEnemy Flag para determinar si se buscan enemigos o aliados
+	 * @param CheckTileAccesibility Si solo se incluyen las casillas alcanzables desde la posicion dada en, como mucho,
+	 * Range pasos a traves de casillas accesibles y sin elementos propios
+	 * @param OutElements Coleccion en la que se almacenan las coordenadas de las casillas
+	 */
+	void GetEnemiesOrAlliesInRange(const FIntPoint& Pos2D, const int32 Range, const bool CheckEnemy,
+	                               const bool CheckTileAccesibility, TSet<FIntPoint>& OutElements) const;
+
+	/**
+	 * Metodo que aplica la funcion dada a cada una de las casillas que se encuentran al alcance desde cierta posicion.
+	 * Se realiza una busqueda de Dijkstra acotada por el alcance, de forma que cada casilla se visita una unica vez
+	 * en orden creciente de coste. La casilla de origen no se incluye
+	 * 
+	 * @param Pos2D Coordenadas en el Array2D
+	 * @param Range Alcance desde la posicion dada
+	 * @param CheckTileCost Si se tiene en cuenta el coste de movimiento de las casillas o cada casilla cuesta 1
+	 * @param CheckTileAccesibility Si se descartan las casillas inaccesibles o que contienen elementos propios
+	 * @param Function Funcion a aplicar sobre la posicion de cada casilla y el coste de llegar a ella
+	 */
+	void ForEachTileWithinRange(const FIntPoint& Pos2D, const int32 Range, const bool CheckTileCost,
+	                            const bool CheckTileAccesibility,
+	                            const TFunctionRef<void(const FIntPoint& Pos, int32 Cost)> Function);
+
+	/**
+	 * Metodo que obtiene las casillas que se encuentran al alcance desde cierta posicion junto con el coste de
+	 * llegar a ellas
+	 * 
+	 * @param Pos2D Coordenadas en el Array2D
+	 * @param Range Alcance desde la posicion dada
+	 * @param CheckTileCost Si se tiene en cuenta el coste de movimiento de las casillas o cada casilla cuesta 1
+	 * @param CheckTileAccesibility Si se descartan las casillas inaccesibles o que contienen elementos propios
+	 * @param InRange Array en el que se almacenan las casillas con su coste de movimiento y el coste total
+	 */
+	void GetReachableTiles(const FIntPoint& Pos2D, const int32 Range, const bool CheckTileCost,
+	                       const bool CheckTileAccesibility, TArray<FMovement>& InRange);
+
 	/**
 	 * Metodo que obtiene la lista de casillas que se encuentran al alcance desde cierta posicion
 	 * 
 	 * @param Pos2D Coordenadas en el Array2D
 	 * @param Range Alcance desde la posicion dada
-	 * @param CheckTileCost
-	 * @param CheckTileAccesibility
-	 * @return Coordenadas de las casillas que se encuentran dentro del rango desde la posicion dada
+	 * @param CheckTileCost Si se tiene en cuenta el coste de movimiento de las casillas o cada casilla cuesta 1
+	 * @param CheckTileAccesibility Si se descartan las casillas inaccesibles o que contienen elementos propios
+	 * @return Coordenadas de las casillas (sin repetir) que se encuentran dentro del rango desde la posicion dada
 	 */
 	UFUNCTION(BlueprintCallable)
 	TArray<FIntPoint> GetTilesWithinRange(const FIntPoint& Pos2D, const int32 Range, const bool CheckTileCost = true,
@@ -771,18 +1105,152 @@ public:
 	//----------------------------------------------------------------------------------------------------------------//
 
 	/**
-	 * Metodo que calcula el mejor camino a seguir a lo largo del mapa para alcanzar una casilla del mismo
+	 * Metodo que obtiene una copia inmutable de la rejilla de casillas. La copia puede emplearse en otros hilos
+	 * mientras el mapa sigue modificandose en el hilo principal y se reutiliza mientras no cambie la version del mapa
+	 * 
+	 * @return Copia compartida de la rejilla de casillas
+	 */
+	FTileGridSnapshot CreateGridSnapshot() const;
+
+	/**
+	 * Metodo que crea la consulta de camino para la faccion en juego. Lee los actores del mapa, por lo que solo debe
+	 * llamarse desde el hilo principal
+	 * 
+	 * @param PosIni Posicion inicial del elemento
+	 * @param PosEnd Posicion de destino del elemento
+	 * @param UnitType Tipo de unidad que se mueve
+	 * @param BaseMovementPoints Puntos de movimiento de la unidad al comienzo de cada turno
+	 * @param MovementPoints Puntos de movimiento actuales de la unidad
+	 * @param OutQuery Consulta de camino creada
+	 * @return Si la peticion de camino es valida
+	 */
+	bool MakePathQuery(const FIntPoint& PosIni, const FIntPoint& PosEnd, const EUnitType UnitType,
+	                   const int32 BaseMovementPoints, const int32 MovementPoints, FPathQuery& OutQuery) const;
+
+	/**
+	 * Metodo que calcula el mejor camino a seguir a lo largo del mapa para alcanzar una casilla del mismo. No modifica
+	 * el mapa ni llama a los eventos de la interfaz
+	 * 
+	 * @param PosIni Posicion inicial del elemento
+	 * @param PosEnd Posicion de destino del elemento
+	 * @param UnitType Tipo de unidad que se mueve
+	 * @param BaseMovementPoints Puntos de movimiento de la unidad al comienzo de cada turno
+	 * @param MovementPoints Puntos de movimiento actuales de la unidad
+	 * @param OutPath Camino calculado, sin incluir la casilla inicial. Vacio si no existe camino
+	 * @param SearchMode Modo de la busqueda. Si no es el automatico, no se emplea la cache de caminos para poder
+	 * comparar los modos
+	 * @return Si se ha encontrado un camino
+	 */
+	bool ComputePath(const FIntPoint& PosIni, const FIntPoint& PosEnd, const EUnitType UnitType,
+	                 const int32 BaseMovementPoints, const int32 MovementPoints, TArray<FMovement>& OutPath,
+	                 const EPathSearchMode SearchMode = EPathSearchMode::Auto) const;
+
+	/**
+	 * Metodo que repara el camino de una unidad de forma incremental. Si el destino no ha cambiado, solo se
+	 * recalculan las casillas afectadas por los cambios del mapa desde la ultima reparacion. En caso contrario, o si
+	 * el registro ya no conserva esos cambios, la busqueda se reinicia
+	 * 
+	 * @param Replanner Estado de la busqueda incremental de la unidad
+	 * @param PosIni Posicion actual de la unidad
+	 * @param PosEnd Posicion de destino de la unidad
+	 * @param UnitType Tipo de unidad que se mueve
+	 * @param BaseMovementPoints Puntos de movimiento de la unidad al comienzo de cada turno
+	 * @param MovementPoints Puntos de movimiento actuales de la unidad
+	 * @param OutPath Camino calculado, sin incluir la casilla inicial. Vacio si no existe camino
+	 * @return Si se ha encontrado un camino
+	 */
+	bool RepairPath(FPathReplanner& Replanner, const FIntPoint& PosIni, const FIntPoint& PosEnd,
+	                const EUnitType UnitType, const int32 BaseMovementPoints, const int32 MovementPoints,
+	                TArray<FMovement>& OutPath) const;
+
+	/**
+	 * Metodo que actualiza el mapa de turnos de una unidad para la faccion en juego. Solo se recalcula si la unidad
+	 * ha cambiado de posicion o de puntos de movimiento, se piden mas turnos o la version del mapa ha cambiado
+	 * 
+	 * @param Map Mapa de turnos de la unidad
+	 * @param Pos Posicion actual de la unidad
+	 * @param BaseMovementPoints Puntos de movimiento de la unidad al comienzo de cada turno
+	 * @param MovementPoints Puntos de movimiento actuales de la unidad
+	 * @param MaxTurns Numero maximo de turnos que se calculan
+	 * @return Si se ha recalculado el mapa
+	 */
+	bool UpdateReachabilityMap(FReachabilityMap& Map, const FIntPoint& Pos, const int32 BaseMovementPoints,
+	                           const int32 MovementPoints, const int32 MaxTurns) const;
+
+	/**
+	 * Metodo que calcula el camino de menor coste para alcanzar una casilla del mapa y lo muestra en la interfaz. El
+	 * camino se almacena para que la interfaz pueda consultarlo y se devuelve una copia
+	 * 
+	 * Opcionalmente se calcula el camino que necesita menos turnos. Las unidades reparan su camino minimizando el
+	 * coste, por lo que este modo solo es adecuado para caminos que no se asignan a una unidad
 	 * 
 	 * @param PosIni Posicion inicial del elemento
 	 * @param PosEnd Posicion de destino del elemento
 	 * @param UnitType Tipo de unidad que se mueve
-	 * @param BaseMovementPoints
-	 * @param MovementPoints
+	 * @param BaseMovementPoints Puntos de movimiento de la unidad al comienzo de cada turno
+	 * @param MovementPoints Puntos de movimiento actuales de la unidad
+	 * @param MinimizeTurns Si se calcula el camino que necesita menos turnos en lugar del de menor coste
 	 * @return El mejor camino a seguir
 	 */
 	UFUNCTION(BlueprintCallable, Category="Map|Pathfinding")
-	const TArray<FMovement>& FindPath(const FIntPoint& PosIni, const FIntPoint& PosEnd, const EUnitType UnitType,
-	                                  const int32 BaseMovementPoints, const int32 MovementPoints);
+	TArray<FMovement> FindPath(const FIntPoint& PosIni, const FIntPoint& PosEnd, const EUnitType UnitType,
+	                           const int32 BaseMovementPoints, const int32 MovementPoints,
+	                           const bool MinimizeTurns = false);
+
+	/**
+	 * Metodo que calcula los caminos de un conjunto de peticiones a la vez. No llama a los eventos de la interfaz, por
+	 * lo que esta pensado para la IA. Las peticiones con el mismo destino comparten una unica busqueda inversa y,
+	 * opcionalmente, los grupos de peticiones se calculan en paralelo
+	 * 
+	 * @param Requests Peticiones de caminos
+	 * @param OutPaths Caminos calculados en el mismo orden que las peticiones, vacios si no existe camino
+	 * @param RunInParallel Si se calculan los grupos de peticiones en varios hilos
+	 */
+	void FindPaths(const TArray<FPathRequest>& Requests, TArray<TArray<FMovement>>& OutPaths,
+	               const bool RunInParallel = false) const;
+
+	/**
+	 * Metodo que calcula un campo de flujo hacia las casillas objetivo dadas para la faccion en juego. Permite que
+	 * varias unidades se muevan hacia el objetivo mas cercano con una unica busqueda
+	 * 
+	 * @param Targets Posiciones en el Array2D de las casillas objetivo
+	 * @param TargetsAreEnemies Si los objetivos son elementos enemigos en los que se puede entrar aunque esten ocupados
+	 * @param OutField Campo de flujo calculado
+	 */
+	void BuildFlowField(const TArray<FIntPoint>& Targets, const bool TargetsAreEnemies, FFlowField& OutField) const;
+
+	/**
+	 * Metodo que obtiene el camino desde una casilla hasta su objetivo mas cercano siguiendo un campo de flujo. Se
+	 * verifica que las casillas del camino sigan siendo validas, ya que los elementos pueden haberse movido desde que
+	 * se calculo el campo
+	 * 
+	 * @param Field Campo de flujo
+	 * @param Pos Posicion inicial en el Array2D
+	 * @param BaseMovementPoints Puntos de movimiento de la unidad al comienzo de cada turno
+	 * @param MovementPoints Puntos de movimiento actuales de la unidad
+	 * @param OutPath Camino hasta el objetivo, sin incluir la casilla inicial
+	 * @return Si se ha obtenido un camino valido
+	 */
+	bool GetFlowFieldPath(const FFlowField& Field, const FIntPoint& Pos, const int32 BaseMovementPoints,
+	                      const int32 MovementPoints, TArray<FMovement>& OutPath) const;
+
+	/**
+	 * Metodo que calcula el camino a seguir hacia una casilla lejana empleando la busqueda jerarquica. Solo se
+	 * calcula el camino exacto (teniendo en cuenta los elementos del mapa) para los primeros turnos de movimiento,
+	 * el resto del camino se obtiene del grafo de clusters. Si el destino esta cerca o la busqueda jerarquica falla,
+	 * se calcula el camino exacto completo. No llama a los eventos de la interfaz
+	 * 
+	 * @param PosIni Posicion inicial del elemento
+	 * @param PosEnd Posicion de destino del elemento
+	 * @param UnitType Tipo de unidad que se mueve
+	 * @param BaseMovementPoints Puntos de movimiento de la unidad al comienzo de cada turno
+	 * @param MovementPoints Puntos de movimiento actuales de la unidad
+	 * @param RefinedTurns Numero de turnos de movimiento para los que se calcula el camino exacto
+	 * @return El camino a seguir
+	 */
+	TArray<FMovement> FindLongRangePath(const FIntPoint& PosIni, const FIntPoint& PosEnd, const EUnitType UnitType,
+	                                    const int32 BaseMovementPoints, const int32 MovementPoints,
+	                                    const int32 RefinedTurns = 2);
 
 	//----------------------------------------------------------------------------------------------------------------//
 
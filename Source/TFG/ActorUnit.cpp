@@ -63,6 +63,43 @@ void AActorUnit::UpdatePosition(const FMovement& Move)
 
 //--------------------------------------------------------------------------------------------------------------------//
 
+const FReachabilityMap& AActorUnit::GetReachabilityMap(const int32 MaxTurns) const
+{
+	// Se actualiza el mapa si la unidad se ha movido o el mapa ha cambiado desde el ultimo calculo
+	if (TileMap)
+	{
+		TileMap->UpdateReachabilityMap(ReachabilityMap, Info.Pos2D, Info.BaseMovementPoints, Info.MovementPoints,
+		                               MaxTurns);
+	}
+
+	return ReachabilityMap;
+}
+
+int32 AActorUnit::GetTurnsToReach(const FIntPoint& Pos, const int32 MaxTurns) const
+{
+	if (!TileMap) return -1;
+
+	const uint8 Turns = GetReachabilityMap(MaxTurns).GetTurns(TileMap->GetGrid().GetIndex(Pos));
+	return Turns != FReachabilityMap::Unreachable ? Turns : -1;
+}
+
+TArray<FIntPoint> AActorUnit::GetTilesReachableInTurn(const int32 Turn) const
+{
+	TArray<FIntPoint> Tiles;
+	if (!TileMap || Turn <= 0) return Tiles;
+
+	// Se recorre el mapa de turnos y se obtienen las casillas alcanzadas en el turno dado
+	const FReachabilityMap& Map = GetReachabilityMap(Turn);
+	for (int32 Index = 0; Index < Map.Turns.Num(); ++Index)
+	{
+		if (Map.Turns[Index] == Turn) Tiles.Add(TileMap->GetGrid().GetPos(Index));
+	}
+
+	return Tiles;
+}
+
+//--------------------------------------------------------------------------------------------------------------------//
+
 void AActorUnit::SetState(const EUnitState State)
 {
 	// Se actualiza el estado
@@ -97,9 +134,10 @@ void AActorUnit::UpdatePath()
 {
 	if (Info.Path.Num() > 0 && TileMap)
 	{
-		// Se recalcula el camino
-		const TArray<FMovement> NewPath = TileMap->FindPath(Info.Pos2D, Info.Path.Last().Pos2D, Info.Type,
-		                                                    Info.BaseMovementPoints, Info.MovementPoints);
+		// Se repara el camino teniendo en cuenta solo las casillas que han cambiado desde la ultima vez
+		TArray<FMovement> NewPath;
+		TileMap->RepairPath(PathReplanner, Info.Pos2D, Info.Path.Last().Pos2D, Info.Type, Info.BaseMovementPoints,
+		                    Info.MovementPoints, NewPath);
 
 		// Se asigna al camino de la unidad
 		AssignPath(NewPath);
@@ -111,6 +149,7 @@ void AActorUnit::RemovePath()
 	// Se limpian los valores almacenados del camino previo
 	Info.Path.Empty();
 	Info.PathCompleted.Empty();
+	PathReplanner.Reset();
 
 	// Se establece el estado de la unidad
 	if (Info.MovementPoints > 0) SetState(EUnitState::WaitingForOrders);
@@ -5,6 +5,8 @@
 #include "CoreMinimal.h"
 #include "ActorDamageableElement.h"
 #include "FMovement.h"
+#include "FPathReplanner.h"
+#include "FReachabilityMap.h"
 #include "FUnitInfo.h"
 #include "GameFramework/Actor.h"
 #include "ActorUnit.generated.h"
@@ -39,6 +41,18 @@ public:
 	AActorUnit();
 
 private:
+	/**
+	 * Estado de la busqueda incremental del camino actual. Permite reparar el camino cuando cambian las casillas sin
+	 * recalcularlo por completo
+	 */
+	FPathReplanner PathReplanner;
+
+	/**
+	 * Turno en el que la unidad alcanza cada casilla. Se recalcula al consultarlo si la unidad se ha movido o la
+	 * version del mapa ha cambiado
+	 */
+	mutable FReachabilityMap ReachabilityMap;
+
 	/**
 	 * Metodo privado que actualiza el estado de la unidad dependiendo del camino asignado y sus puntos de movimiento
 	 */
@@ -135,6 +149,34 @@ public:
 	UFUNCTION(BlueprintCallable)
 	const TArray<FMovement>& GetPath() const { return Info.Path; }
 
+	/**
+	 * Metodo que obtiene el turno en el que la unidad alcanza cada casilla, recalculandolo solo si es necesario
+	 * 
+	 * @param MaxTurns Numero maximo de turnos que se calculan
+	 * @return Mapa de turnos de la unidad
+	 */
+	const FReachabilityMap& GetReachabilityMap(const int32 MaxTurns = 3) const;
+
+	/**
+	 * Metodo que obtiene el turno en el que la unidad alcanza una casilla
+	 * 
+	 * @param Pos Posicion en el Array2D de la casilla
+	 * @param MaxTurns Numero maximo de turnos que se calculan
+	 * @return Turno en el que se alcanza la casilla, 0 si es la casilla de la unidad y -1 si no se alcanza
+	 */
+	UFUNCTION(BlueprintCallable)
+	int32 GetTurnsToReach(const FIntPoint& Pos, const int32 MaxTurns = 3) const;
+
+	/**
+	 * Metodo que obtiene las casillas que la unidad alcanza exactamente en el turno dado. Permite mostrar en la
+	 * interfaz las casillas alcanzables en este turno y en los siguientes
+	 * 
+	 * @param Turn Turno, 1 para el turno actual
+	 * @return Posiciones en el Array2D de las casillas
+	 */
+	UFUNCTION(BlueprintCallable)
+	TArray<FIntPoint> GetTilesReachableInTurn(const int32 Turn) const;
+
 	//----------------------------------------------------------------------------------------------------------------//
 
 	/**
@@ -8,6 +8,7 @@
 #include "ActorTileMap.h"
 #include "LibraryTileMap.h"
 #include "SMain.h"
+#include "Async/Async.h"
 #include "Kismet/GameplayStatics.h"
 
 
@@ -29,8 +30,11 @@ ACMainAI::ACMainAI()
 	// Se inicializa el estado del controlador
 	MilitaryState = EMilitaryState::Neutral;
 
-	// Se inicializa la cola para establecer asentamientos
-	BestTileForSettlement = TPriorityQueue<FTileValue>();
+	// Se inicializa la version del mapa de los valores de atractivo de las casillas
+	SettlementSitesVersion = 0;
+
+	// Se inicializa la version del mapa del analisis del turno en curso
+	PendingAnalysisVersion = 0;
 
 	// Se inicializa la lista de asentamientos planificados
 	PlannedSettlements = TArray<FIntPoint>();
@@ -64,27 +68,6 @@ float ACMainAI::CalculateStrengthDifferenceRelevance(const float StrengthA, cons
 
 //--------------------------------------------------------------------------------------------------------------------//
 
-const AActorSettlement* ACMainAI::GetClosestSettlementFromPos(const FIntPoint& Pos,
-                                                              const TArray<AActorSettlement*>& Settlements)
-{
-	const AActorSettlement* SettlementPos = nullptr;
-
-	// Se calcula la posicion del asentamiento mas cercano
-	int32 MinDistance = 999;
-	for (const auto Settlement : Settlements)
-	{
-		// Se obtiene la distancia y, si es menor, se actualizan las variables de la posicion y distancia
-		const int32 Distance = ULibraryTileMap::GetDistanceToElement(Pos, Settlement->GetPos());
-		if (Distance < MinDistance)
-		{
-			MinDistance = Distance;
-			SettlementPos = Settlement;
-		}
-	}
-
-	return SettlementPos;
-}
-
 FIntPoint ACMainAI::GetClosestTilePos(const FIntPoint& Pos, TArray<FIntPoint>& SettlementOwnedTiles) const
 {
 	FIntPoint ClosestPos = Pos;
@@ -97,7 +80,8 @@ FIntPoint ACMainAI::GetClosestTilePos(const FIntPoint& Pos, TArray<FIntPoint>& S
 			Pos, TSet<FIntPoint>(SettlementOwnedTiles));
 
 		// Si la casilla no contiene ningun elemento, se actualizan las variables y se finaliza el bucle
-		if (!TileMap->TileHasElement(ClosestSettlementTile) && TileMap->IsTileAccesible(ClosestSettlementTile))
+		if (!TileMap->TileHasElement(ClosestSettlementTile) && TileMap->IsTileAccesible(ClosestSettlementTile) &&
+			TileMap->AreTilesConnected(Pos, ClosestSettlementTile))
 		{
 			ClosestPos = ClosestSettlementTile;
 			break;
@@ -115,62 +99,31 @@ FIntPoint ACMainAI::GetClosestTilePos(const FIntPoint& Pos, TArray<FIntPoint>& S
 
 //--------------------------------------------------------------------------------------------------------------------//
 
-void ACMainAI::UpdateTilesValue()
+void ACMainAI::UpdateSettlementSites()
 {
-	// Se crea una cola de valores de atractivo de las casillas para actualizarla
-	TPriorityQueue<FTileValue> BestTileQueue = TPriorityQueue<FTileValue>();
+	const FTileGrid& Grid = TileMap->GetGrid();
 
-	// Se recorren todas las casillas del mapa
-	for (int32 Row = 0; Row < TileMap->GetSize().X; ++Row)
+	// Se obtienen las posiciones en el Array1D de los asentamientos propios
+	TArray<int32> OwnedSettlements;
+	for (const auto Settlement : PawnFaction->GetSettlements())
 	{
-		for (int32 Col = 0; Col < TileMap->GetSize().Y; ++Col)
-		{
-			// Posicion de la casilla actual
-			const FIntPoint Pos = FIntPoint(Row, Col);
-
-			// Si el diccionario no contiene la casilla, se inserta
-			if (!TilesValue.Contains(Pos)) TilesValue.Add(Pos, 0.0);
-
-			// Si no se puede establecer un asentamiento, se le da un valor invalido
-			if (!TileMap->CanSetSettlementAtPos(Pos, PlannedSettlements)) TilesValue[Pos] = -1.0;
-			else
-			{
-				// Se obtiene una referencia al valor para modificarlo
-				float& TileValue = TilesValue[Pos];
-
-				// Se obtiene el asentamiento mas cercano para que el modificador de mas valor a las casillas mas
-				// cercanas con el objetivo de establecer los asentamientos relativamente cerca unos de otros
-				const AActorSettlement* Settlement = GetClosestOwnedSettlementFromPos(Pos);
-				const FIntPoint SettlementPos = Settlement ? Settlement->GetPos() : FIntPoint(-1);
-
-				// Se hace que el valor sumado sea inversamente proporcional a la distancia que se encuentre
-				// el asentamiento
-				TileValue += SettlementPos != -1
-					             ? 10.0 / (ULibraryTileMap::GetDistanceToElement(Pos, SettlementPos) - 3.0)
-					             : 0.0;
-
-				// Si la casilla tiene recursos adyacentes, se aumenta el valor
-				TArray<FIntPoint> InRange = TileMap->GetTilesWithinRange(Pos, 2, false, true);
-
-				for (const auto TilePos : InRange)
-				{
-					if (TileMap->TileHasResource(TilePos))
-					{
-						// Se calcula la distancia
-						const int32 Distance = ULibraryTileMap::GetDistanceToElement(Pos, TilePos);
-						TileValue += Distance == 1 ? 2.0 : Distance == 2 ? 1.0 : 0.0;
-					}
-				}
-			}
+		if (Settlement) OwnedSettlements.Add(Grid.GetIndex(Settlement->GetPos()));
+	}
 
-			// Se actualiza la cola de valores de atractivo de las casillas
-			BestTileQueue.Push(FTileValue(Pos, TilesValue[Pos]));
-		}
+	// Se notifican las casillas modificadas desde la ultima actualizacion o, si no es posible, se recalculan todas
+	TArray<int32> Changes;
+	if (SettlementSites.IsInitialized(Grid) && TileMap->GetTileChangesSince(SettlementSitesVersion, Changes))
+	{
+		for (const int32 Index : Changes) SettlementSites.NotifyTileChanged(Grid, Index);
+		SettlementSites.SetOwnedSettlements(Grid, OwnedSettlements);
+		SettlementSites.Update(Grid, PlannedSettlements);
+	}
+	else
+	{
+		SettlementSites.Init(Grid, OwnedSettlements, PlannedSettlements);
 	}
 
-	// Se actualiza la cola de valores de atractivo de las casillas
-	BestTileForSettlement.Empty();
-	BestTileForSettlement = BestTileQueue;
+	SettlementSitesVersion = TileMap->GetMapVersion();
 }
 
 bool ACMainAI::IsSettlementNeeded() const
@@ -203,21 +156,30 @@ bool ACMainAI::IsResourceGatheringNeeded() const
 	return PendingResourcesToGather.Num() > 0;
 }
 
-FIntPoint ACMainAI::CalculateBestPosForSettlement()
+FIntPoint ACMainAI::CalculateBestPosForSettlement(const FIntPoint& Pos)
 {
 	// Si no hay asentamientos, se establece en la posicion actual
 	if (PawnFaction->GetNumSettlements() == 0) return -1;
 
-	// Se actualizan los valores de atractivo de las casillas y se devuelve el mejor
-	UpdateTilesValue();
+	// Se actualizan los valores de atractivo de las casillas afectadas por los cambios
+	UpdateSettlementSites();
 
-	// Se obtiene el primer elemento de la cola
-	FTileValue BestTile = BestTileForSettlement.Pop();
+	// Se obtiene la mejor casilla que sea alcanzable desde la posicion de la unidad
+	const FTileGrid& Grid = TileMap->GetGrid();
+	const int32 BestIndex = SettlementSites.PopBest([&](const int32 Index)
+	{
+		return TileMap->AreTilesConnected(Pos, Grid.GetPos(Index));
+	});
+
+	// Si no hay ninguna casilla valida, se establece en la posicion actual
+	if (BestIndex == -1) return -1;
 
 	// Se anade la posicion a la lista de asentamientos planificados
-	PlannedSettlements.Add(BestTile.Pos);
+	const FIntPoint BestPos = Grid.GetPos(BestIndex);
+	PlannedSettlements.Add(BestPos);
+	SettlementSites.NotifyPlannedChanged(Grid, BestIndex);
 
-	return BestTile.Pos;
+	return BestPos;
 }
 
 FIntPoint ACMainAI::GetClosestResourceToGatherPos(const FIntPoint& Pos)
@@ -229,6 +191,9 @@ FIntPoint ACMainAI::GetClosestResourceToGatherPos(const FIntPoint& Pos)
 
 	for (const auto ResourcePos : PendingResourcesToGather)
 	{
+		// Si el recurso no es alcanzable desde la posicion, se omite
+		if (!TileMap->AreTilesConnected(Pos, ResourcePos)) continue;
+
 		// Se obtiene la distancia y, si es menor, se actualiza las variables
 		const int32 Distance = ULibraryTileMap::GetDistanceToElement(Pos, ResourcePos);
 		if (Distance < MinDistance && !PlannedResourcesToGather.Contains(ResourcePos))
@@ -253,35 +218,38 @@ FIntPoint ACMainAI::GetClosestResourceToGatherPos(const FIntPoint& Pos)
 TSet<FIntPoint> ACMainAI::GetEnemyOrAllyLocationInRange(const FIntPoint& Pos, const int32 Range,
                                                         const bool GetEnemy, const bool CheckAccessibility) const
 {
-	// Coleccion de casillas con enemigos
+	// Coleccion de casillas con enemigos o aliados, obtenida del indice de ocupacion del mapa
 	TSet<FIntPoint> ElementsLocation = TSet<FIntPoint>();
-
-	// Se obtienen las casillas al alcance de la unidad y se procesan
-	TArray<FIntPoint> TilesInRange = TileMap->GetTilesWithinRange(Pos, Range, false, CheckAccessibility);
-	for (auto TilePos : TilesInRange)
-	{
-		// Si la casilla tiene un enemigo, se anade a la coleccion
-		if (TileMap->TileHasEnemyOrAlly(TilePos, GetEnemy)) ElementsLocation.Add(TilePos);
-	}
+	TileMap->GetEnemiesOrAlliesInRange(Pos, Range, GetEnemy, CheckAccessibility, ElementsLocation);
 
 	return ElementsLocation;
 }
 
 int32 ACMainAI::GetNumCloseUnitsToSettlements(const bool CheckEnemies) const
 {
-	// Se crea la coleccion de enemigos
-	TSet<FIntPoint> CloseUnits = TSet<FIntPoint>();
+	int32 NumCloseUnits = 0;
 
-	// Se obtienen los asentamientos y se procesan
-	const TArray<AActorSettlement*> Settlements = PawnFaction->GetSettlements();
-	for (const auto Settlement : Settlements)
+	// Se procesan las unidades de todas las facciones y se cuentan las que estan a 3 casillas o menos de algun
+	// asentamiento propio, sin contar las que se encuentran en el propio asentamiento
+	if (const ASMain* State = Cast<ASMain>(UGameplayStatics::GetGameState(GetWorld())))
 	{
-		// Se obtienen los enemigos cercanos al asentamiento y se anaden a la coleccion
-		CloseUnits.Append(GetEnemyOrAllyLocationInRange(Settlement->GetPos(), 3, CheckEnemies, false));
+		for (const auto Faction : State->GetFactions())
+		{
+			if (!Faction.Value) continue;
+
+			for (const auto Unit : Faction.Value->GetUnits())
+			{
+				const int32 Distance = TileMap->GetClosestSettlementDistance(Unit->GetPos(), PawnFaction->GetIndex());
+				if (Distance >= 1 && Distance <= 3 && TileMap->TileHasEnemyOrAlly(Unit->GetPos(), CheckEnemies))
+				{
+					++NumCloseUnits;
+				}
+			}
+		}
 	}
 
-	// Se devuelve el numero de enemigos cercanos
-	return CloseUnits.Num();
+	// Se devuelve el numero de unidades cercanas
+	return NumCloseUnits;
 }
 
 const AActorSettlement* ACMainAI::GetClosestEnemySettlementFromPos(const FIntPoint& Pos) const
@@ -290,32 +258,28 @@ const AActorSettlement* ACMainAI::GetClosestEnemySettlementFromPos(const FIntPoi
 
 	if (const ASMain* State = Cast<ASMain>(UGameplayStatics::GetGameState(GetWorld())))
 	{
-		// Variable que almacena la distancia al asentamiento mas cercano
-		int32 MinDistance = 999;
+		// Variable que almacena la distancia al asentamiento mas cercano y su faccion
+		int32 MinDistance = MAX_int32;
+		int32 ClosestFaction = -1;
 
-		// Se obtienen las facciones y se procesan las que aun estan en juego
-		const TMap<int32, APawnFaction*> Factions = State->GetFactions();
+		// Se procesan las facciones en guerra que aun estan en juego
 		for (const auto FactionIndex : State->GetFactionsAlive())
 		{
 			// Si el indice no esta contenido, se omite
 			if (PawnFaction->GetFactionsAtWar().Contains(FactionIndex))
 			{
-				// Se obtienen los asentamientos y se obtiene el mas cercano
-				const AActorSettlement* ClosestSettlement =
-					GetClosestSettlementFromPos(Pos, Factions[FactionIndex]->GetSettlements());
-
-				// Si no se ha obtenido ningun asentamiento, se omite
-				if (!ClosestSettlement) continue;
-
-				// Se obtiene la distancia y, si es menor que la actual, se actualizan las variables
-				const int32 Distance = ULibraryTileMap::GetDistanceToElement(Pos, ClosestSettlement->GetPos());
+				// Se obtiene la distancia al asentamiento mas cercano de la faccion y, si es menor, se actualiza
+				const int32 Distance = TileMap->GetClosestSettlementDistance(Pos, FactionIndex);
 				if (Distance < MinDistance)
 				{
 					MinDistance = Distance;
-					Settlement = ClosestSettlement;
+					ClosestFaction = FactionIndex;
 				}
 			}
 		}
+
+		// Se obtiene el asentamiento mas cercano de la faccion
+		if (ClosestFaction != -1) Settlement = TileMap->GetClosestSettlement(Pos, ClosestFaction);
 	}
 
 	return Settlement;
@@ -324,35 +288,38 @@ const AActorSettlement* ACMainAI::GetClosestEnemySettlementFromPos(const FIntPoi
 const AActorSettlement* ACMainAI::GetClosestOwnedSettlementFromPos(const FIntPoint& Pos) const
 {
 	// Se obtiene el asentamiento mas cercano
-	return GetClosestSettlementFromPos(Pos, PawnFaction->GetSettlements());
+	return TileMap->GetClosestSettlement(Pos, PawnFaction->GetIndex());
 }
 
-FIntPoint ACMainAI::GetFarthestPosFromEnemies(const FIntPoint& Pos, const int32 Range) const
+FIntPoint ACMainAI::GetFarthestPosFromEnemies(const AActorUnit* Unit) const
 {
-	FIntPoint FarthestPos = Pos;
-
-	// Se obtienen las casillas al alcance de la unidad y se procesan
-	TArray<FIntPoint> TilesInRange = TileMap->GetTilesWithinRange(Pos, Range, true, true);
-
-	// Variable que almacena la mayor distancia 
-	int32 MaxDistance = 0;
-
-	// Se calcula la casilla mas alejada de los enemigos teniendo en cuenta el enemigo mas cercano
-	for (const auto TilePos : TilesInRange)
+	const FTileGrid& Grid = TileMap->GetGrid();
+	FIntPoint FarthestPos = Unit->GetPos();
+	const int32 IndexIni = Grid.GetIndex(FarthestPos);
+
+	// La propia unidad forma parte de la influencia aliada, por lo que se descuenta su aportacion para que no cuente
+	// como apoyo en las casillas cercanas a su posicion actual. Su fuerza se obtiene igual que al construir el mapa
+	const float BaseHealth = Unit->GetBaseHealthPoints();
+	const float Health = BaseHealth > 0.0 ? Unit->GetHealthPoints() / BaseHealth : 0.0;
+	const FInfluenceSource Self{IndexIni, Unit->GetStrengthPoints() * Health};
+
+	// Variable que almacena la mayor seguridad, partiendo de la de la casilla actual
+	float MaxSafety = InfluenceMap.GetSafety(IndexIni) - FInfluenceMap::GetInfluence(Grid, Self, IndexIni);
+
+	// Se calcula la casilla mas segura, entre las alcanzables en este turno, segun el mapa de influencia, que tiene en
+	// cuenta la fuerza y la distancia de todos los enemigos y aliados
+	const FReachabilityMap& ReachabilityMap = Unit->GetReachabilityMap(1);
+	for (int32 Index = 0; Index < ReachabilityMap.Turns.Num(); ++Index)
 	{
-		// Si la casilla contiene un enemigo, se omite
-		if (EnemiesLocation.Contains(TilePos)) continue;
+		// Si la casilla no se alcanza en este turno o contiene un enemigo, se omite
+		if (!ReachabilityMap.IsReachable(Index) || EnemiesLocation.Contains(Grid.GetPos(Index))) continue;
 
-		// Se obtiene la posicion del enemigo mas cercano
-		FIntPoint ClosestEnemy = ULibraryTileMap::GetClosestElementFromPos(TilePos, EnemiesLocation);
-		// Variable que almacena la distancia al enemigo mas cercano
-		const int32 MinDistance = ULibraryTileMap::GetDistanceToElement(TilePos, ClosestEnemy);
-
-		// Se actualiza la distancia y la posicion
-		if (MinDistance > MaxDistance)
+		// Se actualiza la seguridad y la posicion
+		const float Safety = InfluenceMap.GetSafety(Index) - FInfluenceMap::GetInfluence(Grid, Self, Index);
+		if (Safety > MaxSafety)
 		{
-			MaxDistance = MinDistance;
-			FarthestPos = TilePos;
+			MaxSafety = Safety;
+			FarthestPos = Grid.GetPos(Index);
 		}
 	}
 
@@ -373,7 +340,8 @@ FIntPoint ACMainAI::GetClosestPosToAlly(const FIntPoint& Pos) const
 	while (ClosestPos != ClosestProvPos)
 	{
 		// Se calcula la casilla adyacente mas cercana, para ello, se obtienen los vecinos
-		TArray<FIntPoint> Neighbors = ULibraryTileMap::GetNeighbors(ClosestProvPos, TileMap->GetSize());
+		FTileNeighbors Neighbors;
+		ULibraryTileMap::FillNeighbors(ClosestProvPos, TileMap->GetSize(), Neighbors);
 		for (const auto NeighborPos : Neighbors)
 		{
 			// Se obtiene la distancia a la casilla
@@ -428,17 +396,33 @@ FIntPoint ACMainAI::GetClosestAllyTilePos(const FIntPoint& Pos) const
 	return GetClosestTilePos(Pos, SettlementOwnedTiles);
 }
 
-FIntPoint ACMainAI::CalculateBestPosForUnit(const FUnitInfo& UnitInfo, const EUnitAction UnitAction) const
+FIntPoint ACMainAI::CalculateBestPosForUnit(const AActorUnit* Unit, const EUnitAction UnitAction) const
 {
-	// Si se debe mover hacia un enemigo, se obtiene el mas cercano
+	const FUnitInfo& UnitInfo = Unit->GetInfo();
+
+	// Si se debe mover hacia un enemigo, se aplica el mismo criterio que el campo de flujo hacia los enemigos: la
+	// distancia mas el coste equivalente a la amenaza de su casilla
 	if (UnitAction == EUnitAction::MoveTowardsEnemy)
 	{
-		return ULibraryTileMap::GetClosestElementFromPos(UnitInfo.Pos2D, EnemiesLocation);
+		FIntPoint BestEnemy = UnitInfo.Pos2D;
+		int32 MinCost = MAX_int32;
+		for (const auto EnemyPos : EnemiesLocation)
+		{
+			const int32 Cost = ULibraryTileMap::GetDistanceToElement(UnitInfo.Pos2D, EnemyPos) +
+				InfluenceMap.GetTargetCost(TileMap->GetGrid().GetIndex(EnemyPos));
+			if (Cost < MinCost)
+			{
+				BestEnemy = EnemyPos;
+				MinCost = Cost;
+			}
+		}
+
+		return BestEnemy;
 	}
 	// Si debe huir de un enemigo, se obtiene la posicion mas alejada en conjunto de todos los enemigos
 	if (UnitAction == EUnitAction::MoveAwayFromEnemy)
 	{
-		return GetFarthestPosFromEnemies(UnitInfo.Pos2D, UnitInfo.MovementPoints);
+		return GetFarthestPosFromEnemies(Unit);
 	}
 	// Si se debe mover hacia un aliado, se obtiene el mas cercano y la posicion mas cercana a este que no este ocupada
 	if (UnitAction == EUnitAction::MoveTowardsAlly)
@@ -458,21 +442,23 @@ FIntPoint ACMainAI::CalculateBestPosForUnit(const FUnitInfo& UnitInfo, const EUn
 	// Si debe explorar, se obtiene aleatoriamente una casilla dentro del alcance de movimiento
 	if (UnitAction == EUnitAction::MoveAround)
 	{
-		// Se obtienen las casillas al alcance de la unidad y se procesan para eliminar las ocupadas
-		TArray<FIntPoint> TilesInRange = TileMap->GetTilesWithinRange(
-			UnitInfo.Pos2D, UnitInfo.MovementPoints, true, true);
-		for (int32 i = 0; i < TilesInRange.Num(); ++i)
+		// Se obtienen las casillas alcanzables en este turno que no esten ocupadas, dando preferencia a las que no
+		// esten dominadas por el enemigo segun el mapa de control
+		TArray<FIntPoint> TilesInRange, ControlledTiles;
+		const FReachabilityMap& ReachabilityMap = Unit->GetReachabilityMap(1);
+		for (int32 Index = 0; Index < ReachabilityMap.Turns.Num(); ++Index)
 		{
-			if (EnemiesLocation.Contains(TilesInRange[i]) || AlliesLocation.Contains(TilesInRange[i]))
-			{
-				// Si la casilla esta ocupada, se elimina la casilla de la lista
-				TilesInRange.RemoveAt(i);
+			if (!ReachabilityMap.IsReachable(Index)) continue;
 
-				// Se actualiza el indice
-				--i;
-			}
+			const FIntPoint TilePos = TileMap->GetGrid().GetPos(Index);
+			if (EnemiesLocation.Contains(TilePos) || AlliesLocation.Contains(TilePos)) continue;
+
+			TilesInRange.Add(TilePos);
+			if (InfluenceMap.GetControl(Index) >= 0.0) ControlledTiles.Add(TilePos);
 		}
 
+		if (ControlledTiles.Num() != 0) TilesInRange = MoveTemp(ControlledTiles);
+
 		// Se verifica si la lista contiene elementos
 		if (TilesInRange.Num() != 0)
 		{
@@ -975,7 +961,7 @@ void ACMainAI::ManageCivilUnit(AActorUnit* Unit)
 			else if (CivilUnit->CanSetSettlement())
 			{
 				// Se obtiene la posicion y se establece el estado de la unidad
-				NewPos = CalculateBestPosForSettlement();
+				NewPos = CalculateBestPosForSettlement(UnitInfo.Pos2D);
 				CivilUnit->SetTargetPos(NewPos != UnitInfo.Pos2D ? NewPos : -1);
 				CivilUnit->SetCivilUnitState(ECivilUnitState::SettingSettlement);
 
@@ -996,7 +982,7 @@ void ACMainAI::ManageCivilUnit(AActorUnit* Unit)
 			/*if (NewPos == UnitInfo.Pos2D && CivilUnit->CanSetSettlement())
 			{
 				// Se obtiene la posicion y se establece el estado de la unidad
-				NewPos = CalculateBestPosForSettlement();
+				NewPos = CalculateBestPosForSettlement(UnitInfo.Pos2D);
 				CivilUnit->SetTargetPos(NewPos != UnitInfo.Pos2D ? NewPos : -1);
 				CivilUnit->SetCivilUnitState(ECivilUnitState::SettingSettlement);
 
@@ -1009,14 +995,14 @@ void ACMainAI::ManageCivilUnit(AActorUnit* Unit)
 		// Si no se ha calculado ninguna accion y la unidad se encuentra sobre un asentamiento, se mueve a otra
 		if (NewPos == UnitInfo.Pos2D && TileMap->GetSettlementsPos().Contains(NewPos))
 		{
-			NewPos = CalculateBestPosForUnit(UnitInfo, EUnitAction::MoveAround);
+			NewPos = CalculateBestPosForUnit(CivilUnit, EUnitAction::MoveAround);
 			CivilUnit->SetTargetPos(-1);
 		}
 
-		// Se calcula el camino a la nueva posicion y se asigna a la unidad
-		const TArray<FMovement> Path = TileMap->FindPath(UnitInfo.Pos2D, NewPos, UnitInfo.Type,
-		                                                 UnitInfo.BaseMovementPoints, UnitInfo.MovementPoints);
-		Unit->AssignPath(Path);
+		// Se anade la peticion del camino a la nueva posicion para calcularlo junto al resto de unidades civiles
+		CivilPathRequests.Add(FPathRequest(UnitInfo.Pos2D, NewPos, UnitInfo.Type, UnitInfo.BaseMovementPoints,
+		                                   UnitInfo.MovementPoints));
+		CivilPathUnits.Add(Unit);
 	}
 }
 
@@ -1108,10 +1094,18 @@ void ACMainAI::ManageMilitaryUnit(AActorUnit* Unit) const
 		Unit->Heal();
 		break;
 	default: //(c)
-		// Se calcula la nueva posicion y el camino que se debe seguir para llegar a ella
-		const FIntPoint NewPos = CalculateBestPosForUnit(UnitInfo, UnitAction);
-		const TArray<FMovement> Path = TileMap->FindPath(UnitInfo.Pos2D, NewPos, UnitInfo.Type,
-		                                                 UnitInfo.BaseMovementPoints, UnitInfo.MovementPoints);
+		// Si la accion consiste en moverse hacia el objetivo mas cercano, se sigue el campo de flujo correspondiente
+		TArray<FMovement> Path;
+		const FFlowField* Field = GetFlowFieldForAction(UnitAction);
+		if (!Field || !TileMap->GetFlowFieldPath(*Field, UnitInfo.Pos2D, UnitInfo.BaseMovementPoints,
+		                                         UnitInfo.MovementPoints, Path))
+		{
+			// En caso contrario, se calcula la nueva posicion y el camino que se debe seguir para llegar a ella. Los
+			// caminos largos se calculan con la busqueda jerarquica y solo se refinan los primeros turnos
+			const FIntPoint NewPos = CalculateBestPosForUnit(Unit, UnitAction);
+			Path = TileMap->FindLongRangePath(UnitInfo.Pos2D, NewPos, UnitInfo.Type, UnitInfo.BaseMovementPoints,
+			                                  UnitInfo.MovementPoints);
+		}
 
 	// Se asigna el camino calculado a la unidad
 		Unit->AssignPath(Path);
@@ -1120,6 +1114,92 @@ void ACMainAI::ManageMilitaryUnit(AActorUnit* Unit) const
 	}
 }
 
+const FFlowField* ACMainAI::GetFlowFieldForAction(const EUnitAction UnitAction) const
+{
+	switch (UnitAction)
+	{
+	case EUnitAction::MoveTowardsEnemyTiles:
+		return &EnemyTilesField;
+	case EUnitAction::MoveTowardsAllyTiles:
+		return &AllyTilesField;
+	case EUnitAction::MoveTowardsEnemy:
+		return &EnemiesField;
+	default:
+		return nullptr;
+	}
+}
+
+FAIAnalysisInput ACMainAI::GetAnalysisInput() const
+{
+	// Se obtiene la copia de la rejilla en la version actual del mapa y las guerras de la faccion
+	FAIAnalysisInput Input(TileMap->CreateGridSnapshot());
+	Input.MapVersion = TileMap->GetMapVersion();
+	Input.Faction = PawnFaction->GetIndex();
+	Input.FactionsAtWar = PawnFaction->GetFactionsAtWar();
+
+	const FTileGrid& Grid = TileMap->GetGrid();
+	const TSet<int32>& FactionsAtWar = Input.FactionsAtWar;
+
+	// Se obtienen las unidades y asentamientos propios y de las facciones en guerra junto con su fuerza. La fuerza de
+	// las unidades se reduce en proporcion a la salud que han perdido
+	if (const ASMain* State = Cast<ASMain>(UGameplayStatics::GetGameState(GetWorld())))
+	{
+		for (const auto Faction : State->GetFactions())
+		{
+			if (!Faction.Value) continue;
+
+			TArray<FInfluenceSource>* Sources = Faction.Value == PawnFaction
+				                                    ? &Input.Friendly
+				                                    : FactionsAtWar.Contains(Faction.Key)
+				                                    ? &Input.Enemies
+				                                    : nullptr;
+			if (!Sources) continue;
+
+			for (const auto Unit : Faction.Value->GetUnits())
+			{
+				if (!Unit || Unit->GetBaseHealthPoints() <= 0.0) continue;
+
+				const float Health = Unit->GetHealthPoints() / Unit->GetBaseHealthPoints();
+				Sources->Add(FInfluenceSource{Grid.GetIndex(Unit->GetPos()), Unit->GetStrengthPoints() * Health});
+			}
+
+			for (const auto Settlement : Faction.Value->GetSettlements())
+			{
+				if (!Settlement) continue;
+
+				Sources->Add(FInfluenceSource{Grid.GetIndex(Settlement->GetPos()), Settlement->GetStrengthPoints()});
+			}
+		}
+	}
+
+	return Input;
+}
+
+void ACMainAI::ApplyTurnAnalysis()
+{
+	// Se recoge el analisis lanzado antes del turno, esperando a que termine si es necesario
+	TSharedPtr<FAIAnalysis, ESPMode::ThreadSafe> Analysis;
+	if (PendingAnalysis.IsValid())
+	{
+		Analysis = PendingAnalysis.Get();
+		PendingAnalysis = TFuture<TSharedPtr<FAIAnalysis, ESPMode::ThreadSafe>>();
+	}
+
+	// Si el mapa o las guerras de la faccion han cambiado desde que se lanzo, se repite con los datos actuales
+	const int32 FactionIndex = PawnFaction->GetIndex();
+	if (!Analysis.IsValid() ||
+		!Analysis->IsValidFor(TileMap->GetMapVersion(), FactionIndex, PawnFaction->GetFactionsAtWar()))
+	{
+		Analysis = MakeShared<FAIAnalysis, ESPMode::ThreadSafe>();
+		FAIAnalysis::Run(GetAnalysisInput(), *Analysis);
+	}
+
+	EnemyTilesField = MoveTemp(Analysis->EnemyTilesField);
+	AllyTilesField = MoveTemp(Analysis->AllyTilesField);
+	EnemiesField = MoveTemp(Analysis->EnemiesField);
+	InfluenceMap = MoveTemp(Analysis->InfluenceMap);
+}
+
 //--------------------------------------------------------------------------------------------------------------------//
 
 EUnitType ACMainAI::CalculateBestUnitTypeToProduce() const
@@ -1223,6 +1303,10 @@ void ACMainAI::ManageUnits()
 		}
 	}
 
+	// Se obtienen los campos de flujo que emplean las unidades militares para moverse hacia el objetivo mas cercano y
+	// los mapas de influencia con los que eligen su destino
+	ApplyTurnAnalysis();
+
 	const TArray<AActorUnit*> Units = PawnFaction->GetUnits();
 	for (const auto Unit : Units)
 	{
@@ -1242,6 +1326,17 @@ void ACMainAI::ManageUnits()
 			else ManageMilitaryUnit(Unit);
 		}
 	}
+
+	// Se calculan a la vez los caminos de las unidades civiles y se asignan
+	TArray<TArray<FMovement>> CivilPaths;
+	TileMap->FindPaths(CivilPathRequests, CivilPaths, true);
+	for (int32 i = 0; i < CivilPathUnits.Num(); ++i)
+	{
+		if (IsValid(CivilPathUnits[i])) CivilPathUnits[i]->AssignPath(CivilPaths[i]);
+	}
+
+	CivilPathRequests.Empty();
+	CivilPathUnits.Empty();
 }
 
 void ACMainAI::ManageSettlementsProduction() const
@@ -1293,15 +1388,6 @@ void ACMainAI::BeginPlay()
 
 	// Se inicializa la instancia del mapa
 	TileMap = Cast<AActorTileMap>(UGameplayStatics::GetActorOfClass(GetWorld(), AActorTileMap::StaticClass()));
-
-	// Si inicializa el diccionario que almacena los valores de atractivo de las casillas
-	for (int32 Row = 0; Row < TileMap->GetSize().X; ++Row)
-	{
-		for (int32 Col = 0; Col < TileMap->GetSize().Y; ++Col)
-		{
-			TilesValue.Add(FIntPoint(Row, Col), 0.0);
-		}
-	}
 }
 
 //--------------------------------------------------------------------------------------------------------------------//
@@ -1387,6 +1473,26 @@ void ACMainAI::ProposeDeal(const FDealInfo& Deal) const
 
 //--------------------------------------------------------------------------------------------------------------------//
 
+void ACMainAI::PrepareTurnAnalysis()
+{
+	// Se trata de inicializar la faccion que gestiona el controlador, si su referencia no es valida
+	if (!PawnFaction) PawnFaction = Cast<APawnFaction>(GetPawn());
+	if (!PawnFaction || !TileMap) return;
+
+	// Si ya hay un analisis lanzado con la version actual del mapa, no se repite
+	if (PendingAnalysis.IsValid() && PendingAnalysisVersion == TileMap->GetMapVersion()) return;
+
+	// Los datos se obtienen en el hilo principal y el analisis, que solo los lee, se realiza en el grafo de tareas
+	// mientras el hilo principal continua con el final del turno anterior y el inicio del turno
+	PendingAnalysisVersion = TileMap->GetMapVersion();
+	PendingAnalysis = Async(EAsyncExecution::TaskGraph, [Input = GetAnalysisInput()]()
+	{
+		TSharedPtr<FAIAnalysis, ESPMode::ThreadSafe> Analysis = MakeShared<FAIAnalysis, ESPMode::ThreadSafe>();
+		FAIAnalysis::Run(Input, *Analysis);
+		return Analysis;
+	});
+}
+
 void ACMainAI::TurnStarted()
 {
 	// Se trata de inicializar la faccion que gestiona el controlador, si su referencia no es valida
@@ -1449,7 +1555,9 @@ void ACMainAI::TurnFinished()
 					CivilUnit->CanSetSettlement() && TileMap->CanSetSettlementAtPos(CivilUnit->GetPos(), {}))
 				{
 					// Se elimina la posicion de los asentamientos planificados
+					const FTileGrid& Grid = TileMap->GetGrid();
 					PlannedSettlements.Remove(CivilUnit->GetPos());
+					SettlementSites.NotifyPlannedChanged(Grid, Grid.GetIndex(CivilUnit->GetPos()));
 
 					// Se crea el asentamiento
 					CivilUnit->CreateSettlement();
@@ -1458,6 +1566,13 @@ void ACMainAI::TurnFinished()
 		}
 	}
 
+	// Una vez realizadas las acciones del turno, se lanza el analisis de la siguiente faccion para que avance durante
+	// la transicion entre turnos
+	if (const AMMain* MainMode = Cast<AMMain>(UGameplayStatics::GetGameMode(GetWorld())))
+	{
+		MainMode->PrepareNextTurnAnalysis();
+	}
+
 	// Se llama al metodo para gestionar el final del turno
 	OnTurnFinished.Broadcast();
 }
@@ -5,9 +5,15 @@
 #include "CoreMinimal.h"
 #include "AIController.h"
 #include "ActorUnit.h"
+#include "FAIAnalysis.h"
+#include "FFlowField.h"
+#include "FInfluenceMap.h"
+#include "FPathRequest.h"
+#include "FSettlementSites.h"
 #include "InterfaceDeal.h"
 #include "MMain.h"
 #include "TPriorityQueue.h"
+#include "Async/Future.h"
 #include "CMainAI.generated.h"
 
 class UDataTable;
@@ -163,10 +169,11 @@ protected:
 	//----------------------------------------------------------------------------------------------------------------//
 
 	/**
-	 * Cola con prioridad que almacena la mejor casilla y el valor de atractivo para establecer un asentamiento
-	 * en cada turno
+	 * Valores de atractivo de las casillas para establecer un asentamiento. Se actualizan de forma incremental a
+	 * partir de los cambios del mapa desde la version SettlementSitesVersion
 	 */
-	TPriorityQueue<FTileValue> BestTileForSettlement;
+	FSettlementSites SettlementSites;
+	uint32 SettlementSitesVersion;
 
 	/**
 	 * Array de posiciones en las que se ha planificado establecer un asentamiento
@@ -174,11 +181,6 @@ protected:
 	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Category="AI")
 	TArray<FIntPoint> PlannedSettlements;
 
-	/**
-	 * Diccionario que almacena los valores de atractivo de las casillas
-	 */
-	TMap<FIntPoint, float> TilesValue;
-
 	/**
 	 * Coleccion de recursos para recolectar
 	 */
@@ -197,6 +199,39 @@ protected:
 
 	TSet<FIntPoint> AlliesLocation;
 
+	/**
+	 * Peticiones de caminos de las unidades civiles del turno. Se calculan todas a la vez al terminar de procesar las
+	 * unidades
+	 */
+	TArray<FPathRequest> CivilPathRequests;
+
+	/**
+	 * Unidades civiles a las que corresponde cada peticion de camino
+	 */
+	TArray<AActorUnit*> CivilPathUnits;
+
+	//----------------------------------------------------------------------------------------------------------------//
+
+	/**
+	 * Campos de flujo hacia las casillas libres en posesion de facciones enemigas, hacia las casillas libres propias y
+	 * hacia los elementos enemigos. Se calculan una vez por turno
+	 */
+	FFlowField EnemyTilesField;
+	FFlowField AllyTilesField;
+	FFlowField EnemiesField;
+
+	/**
+	 * Mapas de influencia de la faccion: amenaza, control y seguridad de cada casilla. Se calculan una vez por turno
+	 */
+	FInfluenceMap InfluenceMap;
+
+	/**
+	 * Analisis del turno que se calcula en el grafo de tareas desde que termina el turno de la faccion anterior. Se
+	 * recoge al gestionar las unidades y se descarta si el mapa ha cambiado desde que se lanzo
+	 */
+	TFuture<TSharedPtr<FAIAnalysis, ESPMode::ThreadSafe>> PendingAnalysis;
+	uint32 PendingAnalysisVersion;
+
 	//----------------------------------------------------------------------------------------------------------------//
 
 	int32 UnitsMoving;
@@ -212,17 +247,15 @@ private:
 
 	//----------------------------------------------------------------------------------------------------------------//
 
-	static const AActorSettlement* GetClosestSettlementFromPos(const FIntPoint& Pos,
-	                                                           const TArray<AActorSettlement*>& Settlements);
 	FIntPoint GetClosestTilePos(const FIntPoint& Pos, TArray<FIntPoint>& SettlementOwnedTiles) const;
 
 	//----------------------------------------------------------------------------------------------------------------//
 
-	void UpdateTilesValue();
+	void UpdateSettlementSites();
 
 	bool IsSettlementNeeded() const;
 	bool IsResourceGatheringNeeded() const;
-	FIntPoint CalculateBestPosForSettlement();
+	FIntPoint CalculateBestPosForSettlement(const FIntPoint& Pos);
 
 	FIntPoint GetClosestResourceToGatherPos(const FIntPoint& Pos);
 
@@ -236,12 +269,16 @@ private:
 	const AActorSettlement* GetClosestEnemySettlementFromPos(const FIntPoint& Pos) const;
 	const AActorSettlement* GetClosestOwnedSettlementFromPos(const FIntPoint& Pos) const;
 
-	FIntPoint GetFarthestPosFromEnemies(const FIntPoint& Pos, const int32 Range) const;
+	FIntPoint GetFarthestPosFromEnemies(const AActorUnit* Unit) const;
 	FIntPoint GetClosestPosToAlly(const FIntPoint& Pos) const;
 	FIntPoint GetClosestEnemyTilePos(const FIntPoint& Pos) const;
 	FIntPoint GetClosestAllyTilePos(const FIntPoint& Pos) const;
 
-	FIntPoint CalculateBestPosForUnit(const FUnitInfo& UnitInfo, const EUnitAction UnitAction) const;
+	FIntPoint CalculateBestPosForUnit(const AActorUnit* Unit, const EUnitAction UnitAction) const;
+
+	const FFlowField* GetFlowFieldForAction(const EUnitAction UnitAction) const;
+	FAIAnalysisInput GetAnalysisInput() const;
+	void ApplyTurnAnalysis();
 
 	//----------------------------------------------------------------------------------------------------------------//
 
@@ -282,6 +319,8 @@ public:
 
 	//----------------------------------------------------------------------------------------------------------------//
 
+	void PrepareTurnAnalysis();
+
 	UFUNCTION(BlueprintCallable)
 	void TurnStarted();
 
@@ -0,0 +1,60 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FAIAnalysis.h"
+
+#include "FPathFinder.h"
+#include "Async/ParallelFor.h"
+
+void FAIAnalysis::Run(const FAIAnalysisInput& Input, FAIAnalysis& OutAnalysis)
+{
+	OutAnalysis.MapVersion = Input.MapVersion;
+	OutAnalysis.Faction = Input.Faction;
+	OutAnalysis.FactionsAtWar = Input.FactionsAtWar;
+
+	const FTileGrid& Grid = *Input.Grid;
+
+	// Se clasifican las casillas accesibles del mapa en una unica pasada
+	TArray<int32> EnemyTiles, AllyTiles, Enemies;
+	for (int32 Index = 0; Index < Grid.Num(); ++Index)
+	{
+		if (!Grid.IsAccesible(Index)) continue;
+
+		// Las casillas ocupadas solo son objetivo si el elemento pertenece a una faccion en guerra
+		if (Grid.HasElement(Index))
+		{
+			if (Input.FactionsAtWar.Contains(Grid.GetElementOwner(Index))) Enemies.Add(Index);
+			continue;
+		}
+
+		if (Grid.Owners[Index] == Input.Faction) AllyTiles.Add(Index);
+		else if (Input.FactionsAtWar.Contains(Grid.Owners[Index])) EnemyTiles.Add(Index);
+	}
+
+	// Cada tarea escribe en un resultado distinto
+	ParallelFor(3, [&](const int32 Task)
+	{
+		switch (Task)
+		{
+		case 0:
+			FPathFinder::BuildFlowField(Grid, EnemyTiles, Input.Faction, false, OutAnalysis.EnemyTilesField);
+			break;
+		case 1:
+			FPathFinder::BuildFlowField(Grid, AllyTiles, Input.Faction, false, OutAnalysis.AllyTilesField);
+			break;
+		default:
+		{
+			// El campo hacia los enemigos parte de la amenaza de cada uno, por lo que se calcula despues del mapa de
+			// influencia para preferir a los enemigos con menos apoyo
+			OutAnalysis.InfluenceMap.Build(Grid, Input.Friendly, Input.Enemies);
+
+			TArray<int32> EnemyCosts;
+			EnemyCosts.Reserve(Enemies.Num());
+			for (const int32 Index : Enemies) EnemyCosts.Add(OutAnalysis.InfluenceMap.GetTargetCost(Index));
+
+			FPathFinder::BuildFlowField(Grid, Enemies, Input.Faction, true, OutAnalysis.EnemiesField, &EnemyCosts);
+			break;
+		}
+		}
+	});
+}
@@ -0,0 +1,97 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FFlowField.h"
+#include "FInfluenceMap.h"
+#include "FTileGrid.h"
+
+/**
+ * Estructura que almacena los datos que necesita el analisis del turno de una faccion. Se rellena en el hilo
+ * principal y despues solo se lee, por lo que el analisis puede ejecutarse en otro hilo
+ */
+struct FAIAnalysisInput
+{
+	/**
+	 * Copia inmutable de la rejilla del mapa
+	 */
+	FTileGridSnapshot Grid;
+
+	/**
+	 * Version del mapa de la que se ha obtenido la rejilla
+	 */
+	uint32 MapVersion = MAX_uint32;
+
+	/**
+	 * Faccion que se analiza y facciones con las que esta en guerra
+	 */
+	int32 Faction = -1;
+	TSet<int32> FactionsAtWar;
+
+	/**
+	 * Elementos propios y de las facciones en guerra para los mapas de influencia
+	 */
+	TArray<FInfluenceSource> Friendly;
+	TArray<FInfluenceSource> Enemies;
+
+	/**
+	 * Constructor con parametros
+	 * 
+	 * @param InGrid Copia inmutable de la rejilla del mapa
+	 */
+	explicit FAIAnalysisInput(const FTileGridSnapshot& InGrid): Grid(InGrid)
+	{
+	}
+};
+
+/**
+ * Estructura que almacena el resultado del analisis de solo lectura del turno de una faccion: los campos de flujo hacia
+ * los objetivos de las unidades militares y los mapas de influencia. Solo es valido si el mapa y las guerras de la
+ * faccion no han cambiado desde que se obtuvieron los datos
+ */
+struct FAIAnalysis
+{
+	/**
+	 * Version del mapa, faccion y facciones en guerra para los que se ha calculado el analisis
+	 */
+	uint32 MapVersion = MAX_uint32;
+	int32 Faction = -1;
+	TSet<int32> FactionsAtWar;
+
+	/**
+	 * Campos de flujo hacia las casillas libres enemigas, hacia las casillas libres propias y hacia los elementos
+	 * enemigos
+	 */
+	FFlowField EnemyTilesField;
+	FFlowField AllyTilesField;
+	FFlowField EnemiesField;
+
+	/**
+	 * Mapas de influencia de la faccion
+	 */
+	FInfluenceMap InfluenceMap;
+
+	/**
+	 * Metodo que verifica si el analisis se puede emplear en el estado actual de la partida
+	 * 
+	 * @param Version Version actual del mapa
+	 * @param F Faccion actual
+	 * @param AtWar Facciones con las que la faccion esta en guerra actualmente
+	 * @return Si el analisis se ha calculado para los mismos datos
+	 */
+	bool IsValidFor(const uint32 Version, const int32 F, const TSet<int32>& AtWar) const
+	{
+		return MapVersion == Version && Faction == F && FactionsAtWar.Num() == AtWar.Num() &&
+			FactionsAtWar.Includes(AtWar);
+	}
+
+	/**
+	 * Metodo estatico que realiza el analisis. Los campos de flujo y los mapas de influencia son independientes, por lo
+	 * que se calculan en paralelo
+	 * 
+	 * @param Input Datos del analisis
+	 * @param OutAnalysis Resultado del analisis
+	 */
+	static void Run(const FAIAnalysisInput& Input, FAIAnalysis& OutAnalysis);
+};
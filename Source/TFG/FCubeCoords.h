@@ -0,0 +1,259 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Estructura que representa una casilla hexagonal en coordenadas cubicas enteras (X + Y + Z = 0). Permite operar
+ * sobre el mapa (distancias, anillos y lineas) sin emplear aritmetica en coma flotante.
+ * 
+ * La conversion desde coordenadas offset sigue la distribucion del mapa (odd-q), donde la fila se almacena en el
+ * componente X del FIntPoint y la columna en el componente Y
+ */
+struct FCubeCoords
+{
+	int32 X;
+	int32 Y;
+	int32 Z;
+
+	/**
+	 * Constructor por defecto. Establece el origen de coordenadas
+	 */
+	constexpr FCubeCoords(): X(0), Y(0), Z(0)
+	{
+	}
+
+	/**
+	 * Constructor con parametros. El tercer componente se deduce de los otros dos
+	 * 
+	 * @param InX Componente X
+	 * @param InY Componente Y
+	 */
+	constexpr FCubeCoords(const int32 InX, const int32 InY): X(InX), Y(InY), Z(-InX - InY)
+	{
+	}
+
+	/**
+	 * Constructor a partir de un FIntVector
+	 * 
+	 * @param Vector Coordenadas cubicas
+	 */
+	explicit FCubeCoords(const FIntVector& Vector): FCubeCoords(Vector.X, Vector.Y)
+	{
+	}
+
+	//----------------------------------------------------------------------------------------------------------------//
+
+	/**
+	 * Metodo estatico que convierte las coordenadas offset dadas a coordenadas cubicas
+	 * 
+	 * @param Row Fila de la casilla
+	 * @param Col Columna de la casilla
+	 * @return Coordenadas cubicas de la casilla
+	 */
+	static constexpr FCubeCoords FromOffset(const int32 Row, const int32 Col)
+	{
+		return FCubeCoords(Col, Row - (Col - (Col & 1)) / 2);
+	}
+
+	/**
+	 * Metodo estatico que convierte las coordenadas offset dadas a coordenadas cubicas
+	 * 
+	 * @param Pos Posicion de la casilla en el Array2D
+	 * @return Coordenadas cubicas de la casilla
+	 */
+	static FCubeCoords FromOffset(const FIntPoint& Pos) { return FromOffset(Pos.X, Pos.Y); }
+
+	/**
+	 * Metodo que devuelve la fila de la casilla en coordenadas offset
+	 * 
+	 * @return Fila de la casilla
+	 */
+	constexpr int32 GetRow() const { return Y + (X - (X & 1)) / 2; }
+
+	/**
+	 * Metodo que devuelve la columna de la casilla en coordenadas offset
+	 * 
+	 * @return Columna de la casilla
+	 */
+	constexpr int32 GetCol() const { return X; }
+
+	/**
+	 * Metodo que convierte las coordenadas cubicas a coordenadas offset
+	 * 
+	 * @return Posicion de la casilla en el Array2D
+	 */
+	FIntPoint ToOffset() const { return FIntPoint(GetRow(), GetCol()); }
+
+	/**
+	 * Metodo que convierte las coordenadas a un FIntVector
+	 * 
+	 * @return Coordenadas cubicas como FIntVector
+	 */
+	FIntVector ToIntVector() const { return FIntVector(X, Y, Z); }
+
+	//----------------------------------------------------------------------------------------------------------------//
+
+	constexpr FCubeCoords operator+(const FCubeCoords& Other) const { return FCubeCoords(X + Other.X, Y + Other.Y); }
+
+	constexpr FCubeCoords operator-(const FCubeCoords& Other) const { return FCubeCoords(X - Other.X, Y - Other.Y); }
+
+	constexpr FCubeCoords operator*(const int32 Scale) const { return FCubeCoords(X * Scale, Y * Scale); }
+
+	constexpr bool operator==(const FCubeCoords& Other) const { return X == Other.X && Y == Other.Y; }
+
+	constexpr bool operator!=(const FCubeCoords& Other) const { return !(*this == Other); }
+
+	//----------------------------------------------------------------------------------------------------------------//
+
+	/**
+	 * Metodo estatico que devuelve una de las seis direcciones de la rejilla hexagonal
+	 * 
+	 * @param Direction Indice de la direccion [0, 5]
+	 * @return Desplazamiento en coordenadas cubicas
+	 */
+	static constexpr FCubeCoords GetDirection(const int32 Direction)
+	{
+		return Direction == 0
+			       ? FCubeCoords(1, -1)
+			       : Direction == 1
+			       ? FCubeCoords(1, 0)
+			       : Direction == 2
+			       ? FCubeCoords(0, 1)
+			       : Direction == 3
+			       ? FCubeCoords(-1, 1)
+			       : Direction == 4
+			       ? FCubeCoords(-1, 0)
+			       : FCubeCoords(0, -1);
+	}
+
+	/**
+	 * Metodo estatico que calcula la distancia en casillas entre dos coordenadas
+	 * 
+	 * @param A Coordenadas de la primera casilla
+	 * @param B Coordenadas de la segunda casilla
+	 * @return Numero de casillas entre ambas coordenadas
+	 */
+	static constexpr int32 Distance(const FCubeCoords& A, const FCubeCoords& B)
+	{
+		return Length(A.X - B.X, A.Y - B.Y);
+	}
+
+	/**
+	 * Metodo estatico que calcula la distancia en casillas desde una coordenada hasta un conjunto de coordenadas.
+	 * Las coordenadas de destino se reciben como arrays separados por componente para que el bucle pueda ser
+	 * vectorizado por el compilador
+	 * 
+	 * @param From Coordenadas de origen
+	 * @param ToX Componentes X de las coordenadas de destino
+	 * @param ToY Componentes Y de las coordenadas de destino
+	 * @param Num Numero de coordenadas de destino
+	 * @param OutDistances Array en el que se almacenan las distancias (debe tener al menos Num elementos)
+	 */
+	static void Distances(const FCubeCoords& From, const int32* RESTRICT ToX, const int32* RESTRICT ToY,
+	                      const int32 Num, int32* RESTRICT OutDistances)
+	{
+		for (int32 i = 0; i < Num; ++i) OutDistances[i] = Length(ToX[i] - From.X, ToY[i] - From.Y);
+	}
+
+	//----------------------------------------------------------------------------------------------------------------//
+
+	/**
+	 * Metodo estatico que aplica la funcion dada a cada una de las coordenadas del anillo de radio dado alrededor de
+	 * un centro. Las coordenadas pueden quedar fuera del mapa, por lo que deben comprobarse
+	 * 
+	 * @param Center Coordenadas del centro
+	 * @param Radius Radio del anillo
+	 * @param Function Funcion a aplicar sobre cada coordenada
+	 */
+	template <typename FunctionType>
+	static void ForEachInRing(const FCubeCoords& Center, const int32 Radius, FunctionType&& Function)
+	{
+		if (Radius <= 0)
+		{
+			if (Radius == 0) Function(Center);
+			return;
+		}
+
+		// Se parte de una de las esquinas del anillo y se recorren sus seis lados
+		FCubeCoords Current = Center + GetDirection(4) * Radius;
+		for (int32 Direction = 0; Direction < 6; ++Direction)
+		{
+			for (int32 Step = 0; Step < Radius; ++Step)
+			{
+				Function(Current);
+				Current = Current + GetDirection(Direction);
+			}
+		}
+	}
+
+	/**
+	 * Metodo estatico que aplica la funcion dada a cada una de las coordenadas de la linea que une dos casillas,
+	 * ambas incluidas
+	 * 
+	 * @param A Coordenadas de la casilla inicial
+	 * @param B Coordenadas de la casilla final
+	 * @param Function Funcion a aplicar sobre cada coordenada
+	 */
+	template <typename FunctionType>
+	static void ForEachInLine(const FCubeCoords& A, const FCubeCoords& B, FunctionType&& Function)
+	{
+		const int32 N = Distance(A, B);
+		if (N == 0)
+		{
+			Function(A);
+			return;
+		}
+
+		// Se desplazan ligeramente los extremos para que los puntos que caen entre dos casillas se resuelvan siempre
+		// hacia el mismo lado
+		const double AX = A.X + 1e-6, AY = A.Y + 2e-6, AZ = A.Z - 3e-6;
+		const double BX = B.X + 1e-6, BY = B.Y + 2e-6, BZ = B.Z - 3e-6;
+
+		for (int32 i = 0; i <= N; ++i)
+		{
+			const double T = static_cast<double>(i) / N;
+			Function(Round(AX + (BX - AX) * T, AY + (BY - AY) * T, AZ + (BZ - AZ) * T));
+		}
+	}
+
+private:
+	/**
+	 * Metodo estatico que calcula la longitud de un desplazamiento en coordenadas cubicas
+	 * 
+	 * @param DX Desplazamiento en X
+	 * @param DY Desplazamiento en Y
+	 * @return Numero de casillas del desplazamiento
+	 */
+	static constexpr int32 Length(const int32 DX, const int32 DY)
+	{
+		const int32 AX = DX < 0 ? -DX : DX;
+		const int32 AY = DY < 0 ? -DY : DY;
+		const int32 AZ = DX + DY < 0 ? -(DX + DY) : DX + DY;
+
+		return AX > AY ? (AX > AZ ? AX : AZ) : (AY > AZ ? AY : AZ);
+	}
+
+	/**
+	 * Metodo estatico que redondea unas coordenadas cubicas fraccionarias a la casilla mas cercana
+	 * 
+	 * @param FX Componente X
+	 * @param FY Componente Y
+	 * @param FZ Componente Z
+	 * @return Coordenadas de la casilla mas cercana
+	 */
+	static FCubeCoords Round(const double FX, const double FY, const double FZ)
+	{
+		int32 RX = static_cast<int32>(FMath::FloorToDouble(FX + 0.5));
+		int32 RY = static_cast<int32>(FMath::FloorToDouble(FY + 0.5));
+		const int32 RZ = static_cast<int32>(FMath::FloorToDouble(FZ + 0.5));
+
+		// Se corrige el componente con mayor error para mantener la restriccion X + Y + Z = 0
+		const double DX = FMath::Abs(RX - FX), DY = FMath::Abs(RY - FY), DZ = FMath::Abs(RZ - FZ);
+		if (DX > DY && DX > DZ) RX = -RY - RZ;
+		else if (DY > DZ) RY = -RX - RZ;
+
+		return FCubeCoords(RX, RY);
+	}
+};
@@ -0,0 +1,155 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "FCubeCoords.h"
+#include "LibraryTileMap.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCubeCoordsDistanceTest, "TFG.TileMap.CubeCoords.Distance",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+/**
+ * Funcion que calcula la distancia entre dos casillas con la formula previa en coma flotante, que convertia las
+ * coordenadas offset a un FVector
+ * 
+ * @param PosIni Posicion inicial
+ * @param PosEnd Posicion final
+ * @return Numero de casillas entre ambas posiciones
+ */
+static int32 GetFloatDistance(const FIntPoint& PosIni, const FIntPoint& PosEnd)
+{
+	const auto ToCube = [](const FIntPoint& Pos)
+	{
+		const int32 X = Pos.Y;
+		const int32 Y = Pos.X - (Pos.Y - (Pos.Y & 1)) / 2;
+		return FVector(X, Y, -X - Y);
+	};
+
+	const FVector Distance = ToCube(PosEnd) - ToCube(PosIni);
+	return FMath::Max3(FMath::Abs(Distance.X), FMath::Abs(Distance.Y), FMath::Abs(Distance.Z));
+}
+
+bool FCubeCoordsDistanceTest::RunTest(const FString& Parameters)
+{
+	// Se comparan ambas formulas entre todas las casillas de una rejilla que incluye columnas pares e impares
+	constexpr int32 Rows = 12;
+	constexpr int32 Cols = 13;
+
+	for (int32 RowIni = 0; RowIni < Rows; ++RowIni)
+	{
+		for (int32 ColIni = 0; ColIni < Cols; ++ColIni)
+		{
+			const FIntPoint PosIni(RowIni, ColIni);
+
+			// La conversion a coordenadas cubicas debe poder deshacerse
+			if (!TestEqual(TEXT("ToOffset(FromOffset(Pos))"), FCubeCoords::FromOffset(PosIni).ToOffset(), PosIni))
+			{
+				return false;
+			}
+
+			for (int32 RowEnd = 0; RowEnd < Rows; ++RowEnd)
+			{
+				for (int32 ColEnd = 0; ColEnd < Cols; ++ColEnd)
+				{
+					const FIntPoint PosEnd(RowEnd, ColEnd);
+
+					const int32 Expected = GetFloatDistance(PosIni, PosEnd);
+					const int32 Distance = FCubeCoords::Distance(FCubeCoords::FromOffset(PosIni),
+					                                             FCubeCoords::FromOffset(PosEnd));
+
+					const FString What = FString::Printf(TEXT("Distance (%d, %d) -> (%d, %d)"), RowIni, ColIni,
+					                                     RowEnd, ColEnd);
+					if (!TestEqual(What, Distance, Expected)) return false;
+					if (!TestEqual(What, ULibraryTileMap::GetDistanceToElement(PosIni, PosEnd), Expected)) return false;
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCubeCoordsBatchDistanceTest, "TFG.TileMap.CubeCoords.BatchDistance",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FCubeCoordsBatchDistanceTest::RunTest(const FString& Parameters)
+{
+	// Se emplean como destinos todas las casillas de una rejilla con columnas pares e impares
+	constexpr int32 Rows = 9;
+	constexpr int32 Cols = 11;
+
+	TArray<FIntPoint> Locations;
+	for (int32 Row = 0; Row < Rows; ++Row)
+	{
+		for (int32 Col = 0; Col < Cols; ++Col) Locations.Add(FIntPoint(Row, Col));
+	}
+
+	for (const FIntPoint& Pos : Locations)
+	{
+		// Las distancias en bloque deben coincidir con las calculadas de una en una
+		TArray<int32> Distances;
+		ULibraryTileMap::GetDistancesToElements(Pos, Locations, Distances);
+		if (!TestEqual(TEXT("Num distances"), Distances.Num(), Locations.Num())) return false;
+
+		for (int32 i = 0; i < Locations.Num(); ++i)
+		{
+			const FString What = FString::Printf(TEXT("Batch distance (%d, %d) -> (%d, %d)"), Pos.X, Pos.Y,
+			                                     Locations[i].X, Locations[i].Y);
+			if (!TestEqual(What, Distances[i], GetFloatDistance(Pos, Locations[i]))) return false;
+		}
+
+		// El elemento mas cercano debe estar a la menor distancia de los elementos dados
+		const TSet<FIntPoint> Elements = {FIntPoint(0, 0), FIntPoint(Rows - 1, Cols - 1), FIntPoint(4, 5)};
+		int32 MinDistance = MAX_int32;
+		for (const FIntPoint& Element : Elements) MinDistance = FMath::Min(MinDistance, GetFloatDistance(Pos, Element));
+
+		const FIntPoint Closest = ULibraryTileMap::GetClosestElementFromPos(Pos, Elements);
+		if (!TestEqual(TEXT("Closest element distance"), GetFloatDistance(Pos, Closest), MinDistance)) return false;
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCubeCoordsLineTest, "TFG.TileMap.CubeCoords.Line",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FCubeCoordsLineTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 Rows = 9;
+	constexpr int32 Cols = 11;
+
+	for (int32 RowIni = 0; RowIni < Rows; ++RowIni)
+	{
+		for (int32 ColIni = 0; ColIni < Cols; ++ColIni)
+		{
+			for (int32 RowEnd = 0; RowEnd < Rows; ++RowEnd)
+			{
+				for (int32 ColEnd = 0; ColEnd < Cols; ++ColEnd)
+				{
+					const FCubeCoords A = FCubeCoords::FromOffset(RowIni, ColIni);
+					const FCubeCoords B = FCubeCoords::FromOffset(RowEnd, ColEnd);
+
+					TArray<FCubeCoords> Line;
+					FCubeCoords::ForEachInLine(A, B, [&Line](const FCubeCoords& Coords) { Line.Add(Coords); });
+
+					// La linea contiene una casilla por paso, empieza y acaba en los extremos y cada casilla es
+					// vecina de la anterior
+					const FString What = FString::Printf(TEXT("Line (%d, %d) -> (%d, %d)"), RowIni, ColIni, RowEnd,
+					                                     ColEnd);
+					if (!TestEqual(What, Line.Num(), FCubeCoords::Distance(A, B) + 1)) return false;
+					if (!TestTrue(What, Line[0] == A && Line.Last() == B)) return false;
+
+					for (int32 i = 1; i < Line.Num(); ++i)
+					{
+						if (!TestEqual(What, FCubeCoords::Distance(Line[i - 1], Line[i]), 1)) return false;
+					}
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,67 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Estructura que almacena un campo de flujo hacia un conjunto de casillas objetivo. Se calcula con una unica busqueda
+ * (Dijkstra) desde todos los objetivos a la vez, de forma que cualquier casilla conoce en O(1) el coste de movimiento
+ * hasta el objetivo mas cercano y la siguiente casilla en la que debe entrar para llegar a el.
+ * 
+ * Los arrays estan indexados por la posicion de la casilla en el Array1D
+ */
+struct FFlowField
+{
+	/**
+	 * Coste de movimiento hasta el objetivo mas cercano, MAX_int32 si no se puede alcanzar ninguno
+	 */
+	TArray<int32> Costs;
+
+	/**
+	 * Siguiente casilla del camino hacia el objetivo mas cercano, -1 en los objetivos y en las casillas inalcanzables
+	 */
+	TArray<int32> Next;
+
+	/**
+	 * Objetivo mas cercano a cada casilla, -1 si no se puede alcanzar ninguno
+	 */
+	TArray<int32> Targets;
+
+	/**
+	 * Faccion para la que se ha calculado el campo
+	 */
+	int32 Faction = -1;
+
+	/**
+	 * Si los objetivos son elementos enemigos, en cuyo caso se puede entrar en ellos aunque esten ocupados
+	 */
+	bool TargetsAreEnemies = false;
+
+	/**
+	 * Metodo que inicializa el campo para el numero de casillas dado sin ninguna casilla alcanzable
+	 * 
+	 * @param NumTiles Numero de casillas del mapa
+	 */
+	void Init(const int32 NumTiles)
+	{
+		Costs.Init(MAX_int32, NumTiles);
+		Next.Init(-1, NumTiles);
+		Targets.Init(-1, NumTiles);
+	}
+
+	/**
+	 * Metodo que devuelve el numero de casillas del campo
+	 * 
+	 * @return Numero de casillas
+	 */
+	int32 Num() const { return Costs.Num(); }
+
+	/**
+	 * Metodo que verifica si desde una casilla se puede alcanzar algun objetivo
+	 * 
+	 * @param Index Posicion en el Array1D
+	 * @return Si existe un camino hacia algun objetivo
+	 */
+	bool IsReachable(const int32 Index) const { return Costs.IsValidIndex(Index) && Costs[Index] != MAX_int32; }
+};
@@ -0,0 +1,339 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FHexClusterGraph.h"
+
+#include "Algo/Reverse.h"
+#include "TPriorityQueue.h"
+
+void FHexClusterGraph::Init(const FTileGrid& Grid)
+{
+	ClusterRows = FMath::DivideAndRoundUp(Grid.Rows, ClusterSize);
+	ClusterCols = FMath::DivideAndRoundUp(Grid.Cols, ClusterSize);
+
+	// Se eliminan los clusters previos y se marcan todos como pendientes de calcularse
+	Clusters.Empty();
+	Clusters.SetNum(ClusterRows * ClusterCols);
+	EntranceIds.Init(-1, Grid.Num());
+
+	HasDirty = Clusters.Num() > 0;
+}
+
+void FHexClusterGraph::MarkDirty(const FTileGrid& Grid, const int32 Index)
+{
+	// Si los clusters no corresponden a la rejilla actual, se omite ya que se inicializaran al terminar el mapa
+	if (Clusters.Num() == 0 || EntranceIds.Num() != Grid.Num()) return;
+
+	const int32 Cluster = GetCluster(Grid, Index);
+	if (!Clusters.IsValidIndex(Cluster)) return;
+
+	Clusters[Cluster].Dirty = true;
+	HasDirty = true;
+}
+
+//--------------------------------------------------------------------------------------------------------------------//
+
+void FHexClusterGraph::Rebuild(const FTileGrid& Grid)
+{
+	// Se recalculan los clusters modificados y sus vecinos, ya que comparten las entradas de la frontera
+	TBitArray<> Rebuilding(false, Clusters.Num());
+	for (int32 Cluster = 0; Cluster < Clusters.Num(); ++Cluster)
+	{
+		if (!Clusters[Cluster].Dirty) continue;
+
+		const int32 ClusterRow = Cluster / ClusterCols;
+		const int32 ClusterCol = Cluster % ClusterCols;
+		for (int32 Row = FMath::Max(ClusterRow - 1, 0); Row <= FMath::Min(ClusterRow + 1, ClusterRows - 1); ++Row)
+		{
+			for (int32 Col = FMath::Max(ClusterCol - 1, 0); Col <= FMath::Min(ClusterCol + 1, ClusterCols - 1); ++Col)
+			{
+				Rebuilding[Row * ClusterCols + Col] = true;
+			}
+		}
+	}
+
+	// Se eliminan las entradas de los clusters a recalcular
+	for (TConstSetBitIterator<> It(Rebuilding); It; ++It)
+	{
+		FHexCluster& Cluster = Clusters[It.GetIndex()];
+		for (const int32 Tile : Cluster.Entrances) EntranceIds[Tile] = -1;
+
+		Cluster.Entrances.Reset();
+		Cluster.Links.Reset();
+	}
+
+	// Se obtienen las parejas de casillas accesibles a ambos lados de cada frontera. Cada pareja se almacena
+	// empezando por la casilla del cluster de menor indice y cada frontera se procesa una unica vez
+	TMap<int32, TArray<TPair<int32, int32>>> Borders;
+	for (TConstSetBitIterator<> It(Rebuilding); It; ++It)
+	{
+		const int32 Cluster = It.GetIndex();
+		ForEachTileInCluster(Grid, Cluster, [&](const int32 Tile)
+		{
+			if (!Grid.IsAccesible(Tile)) return;
+
+			Grid.ForEachNeighbor(Tile, [&](const int32 Neighbor)
+			{
+				const int32 Other = GetCluster(Grid, Neighbor);
+				if (Other == Cluster || !Grid.IsAccesible(Neighbor)) return;
+
+				// Si el otro cluster tambien se recalcula, la pareja se obtiene desde el de menor indice
+				if (Rebuilding[Other] && Other < Cluster) return;
+
+				const int32 Low = FMath::Min(Cluster, Other);
+				const int32 High = FMath::Max(Cluster, Other);
+				Borders.FindOrAdd(Low * Clusters.Num() + High).Add(
+					Cluster == Low ? TPair<int32, int32>(Tile, Neighbor) : TPair<int32, int32>(Neighbor, Tile));
+			});
+		});
+	}
+
+	// Se crea una entrada por cada grupo de parejas consecutivas. Las parejas se ordenan para que el resultado no
+	// dependa del cluster desde el que se han obtenido, de forma que los clusters que no se recalculan mantienen
+	// exactamente las mismas entradas
+	for (auto& Border : Borders)
+	{
+		const int32 Low = Border.Key / Clusters.Num();
+		const int32 High = Border.Key % Clusters.Num();
+
+		TArray<TPair<int32, int32>>& Pairs = Border.Value;
+		Pairs.Sort([](const TPair<int32, int32>& A, const TPair<int32, int32>& B)
+		{
+			return A.Key != B.Key ? A.Key < B.Key : A.Value < B.Value;
+		});
+
+		for (int32 First = 0; First < Pairs.Num(); First += EntranceSpacing)
+		{
+			const int32 Middle = FMath::Min(First + EntranceSpacing / 2, Pairs.Num() - 1);
+			const TPair<int32, int32>& Pair = Pairs[Middle];
+
+			if (Rebuilding[Low]) AddEntrance(Low, Pair.Key, Pair.Value);
+			if (Rebuilding[High]) AddEntrance(High, Pair.Value, Pair.Key);
+		}
+	}
+
+	// Se recalculan los caminos entre las entradas de cada cluster
+	for (TConstSetBitIterator<> It(Rebuilding); It; ++It)
+	{
+		BuildIntraEdges(Grid, It.GetIndex());
+		Clusters[It.GetIndex()].Dirty = false;
+	}
+
+	HasDirty = false;
+}
+
+void FHexClusterGraph::AddEntrance(const int32 Cluster, const int32 Tile, const int32 Partner)
+{
+	FHexCluster& ClusterData = Clusters[Cluster];
+
+	int32& Id = EntranceIds[Tile];
+	if (Id == -1)
+	{
+		Id = ClusterData.Entrances.Add(Tile);
+		ClusterData.Links.AddDefaulted();
+	}
+
+	ClusterData.Links[Id].AddUnique(Partner);
+}
+
+void FHexClusterGraph::BuildIntraEdges(const FTileGrid& Grid, const int32 Cluster)
+{
+	FHexCluster& ClusterData = Clusters[Cluster];
+	const int32 Num = ClusterData.Entrances.Num();
+
+	ClusterData.Distances.Init(-1, Num * Num);
+	ClusterData.Paths.Reset();
+	ClusterData.Paths.SetNum(Num * Num);
+
+	// Se realiza una busqueda desde cada entrada y se almacenan los costes y caminos hasta el resto
+	for (int32 i = 0; i < Num; ++i)
+	{
+		const int32 Start = ClusterData.Entrances[i];
+		SearchCluster(Grid, Cluster, Start, LocalWorkspace);
+
+		for (int32 j = 0; j < Num; ++j)
+		{
+			const int32 End = ClusterData.Entrances[j];
+			if (i == j || !LocalWorkspace.IsVisited(End)) continue;
+
+			ClusterData.Distances[i * Num + j] = LocalWorkspace.Cost[End];
+			AppendPath(LocalWorkspace, Start, End, ClusterData.Paths[i * Num + j]);
+		}
+	}
+}
+
+void FHexClusterGraph::SearchCluster(const FTileGrid& Grid, const int32 Cluster, const int32 Start,
+                                     FPathWorkspace& Workspace) const
+{
+	Workspace.Init(Grid.Num());
+	Workspace.NewSearch();
+	Workspace.SetNode(Start, 0, -1);
+
+	TPriorityQueue<FHexClusterNode> Frontier;
+	Frontier.Push({Start, 0});
+
+	while (!Frontier.IsEmpty())
+	{
+		const FHexClusterNode Current = Frontier.Pop();
+		const int32 CurrentCost = Workspace.Cost[Current.Index];
+
+		// Si la entrada ha quedado obsoleta, se descarta
+		if (Current.Priority > CurrentCost) continue;
+
+		Grid.ForEachNeighbor(Current.Index, [&](const int32 Neighbor)
+		{
+			// Solo se consideran las casillas accesibles del propio cluster
+			if (!Grid.IsAccesible(Neighbor) || GetCluster(Grid, Neighbor) != Cluster) return;
+
+			const int32 NewCost = CurrentCost + Grid.Costs[Neighbor];
+			if (NewCost < Workspace.GetCost(Neighbor))
+			{
+				Workspace.SetNode(Neighbor, NewCost, Current.Index);
+				Frontier.Push({Neighbor, NewCost});
+			}
+		});
+	}
+}
+
+void FHexClusterGraph::AppendPath(const FPathWorkspace& Workspace, const int32 Start, const int32 End,
+                                  TArray<int32>& OutPath)
+{
+	const int32 First = OutPath.Num();
+	for (int32 Index = End; Index != Start; Index = Workspace.Parent[Index]) OutPath.Add(Index);
+
+	// Se invierte el tramo anadido para que comience junto a la casilla inicial
+	Algo::Reverse(OutPath.GetData() + First, OutPath.Num() - First);
+}
+
+//--------------------------------------------------------------------------------------------------------------------//
+
+bool FHexClusterGraph::FindPath(const FTileGrid& Grid, const int32 IndexIni, const int32 IndexEnd,
+                                TArray<int32>& OutPath)
+{
+	OutPath.Reset();
+
+	if (EntranceIds.Num() != Grid.Num() || Clusters.Num() == 0) return false;
+	if (IndexIni == IndexEnd || !Grid.IsAccesible(IndexIni) || !Grid.IsAccesible(IndexEnd)) return false;
+
+	// Se recalculan los clusters modificados desde la ultima busqueda
+	if (HasDirty) Rebuild(Grid);
+
+	// Se conectan temporalmente las casillas inicial y final con las entradas de sus clusters. Como el coste de un
+	// movimiento es el de la casilla a la que se entra, el coste de ir de una entrada E al destino D se obtiene a
+	// partir del camino inverso como Coste(D, E) - Coste(E) + Coste(D)
+	const int32 StartCluster = GetCluster(Grid, IndexIni);
+	const int32 GoalCluster = GetCluster(Grid, IndexEnd);
+	SearchCluster(Grid, StartCluster, IndexIni, StartWorkspace);
+	SearchCluster(Grid, GoalCluster, IndexEnd, GoalWorkspace);
+
+	const FIntPoint PosEnd = Grid.GetPos(IndexEnd);
+	auto Heuristic = [&](const int32 Index)
+	{
+		return ULibraryTileMap::GetDistanceToElement(Grid.GetPos(Index), PosEnd);
+	};
+
+	// Se realiza la busqueda A* sobre el grafo de entradas
+	AbstractWorkspace.Init(Grid.Num());
+	AbstractWorkspace.NewSearch();
+	AbstractWorkspace.SetNode(IndexIni, 0, -1);
+
+	TPriorityQueue<FHexClusterNode> Frontier;
+	Frontier.Push({IndexIni, Heuristic(IndexIni)});
+
+	auto Relax = [&](const int32 From, const int32 To, const int32 NewCost)
+	{
+		if (NewCost < AbstractWorkspace.GetCost(To))
+		{
+			AbstractWorkspace.SetNode(To, NewCost, From);
+			Frontier.Push({To, NewCost + Heuristic(To)});
+		}
+	};
+
+	bool Found = false;
+	while (!Frontier.IsEmpty())
+	{
+		const FHexClusterNode Current = Frontier.Pop();
+		const int32 Index = Current.Index;
+		const int32 Cost = AbstractWorkspace.Cost[Index];
+
+		// Si la entrada ha quedado obsoleta, se descarta
+		if (Current.Priority > Cost + Heuristic(Index)) continue;
+
+		if (Index == IndexEnd)
+		{
+			Found = true;
+			break;
+		}
+
+		// Desde la casilla inicial se puede llegar a cualquier entrada de su cluster o al destino si comparten cluster
+		if (Index == IndexIni)
+		{
+			for (const int32 Entrance : Clusters[StartCluster].Entrances)
+			{
+				if (Entrance != IndexIni && StartWorkspace.IsVisited(Entrance))
+				{
+					Relax(Index, Entrance, StartWorkspace.Cost[Entrance]);
+				}
+			}
+
+			if (StartCluster == GoalCluster && StartWorkspace.IsVisited(IndexEnd))
+			{
+				Relax(Index, IndexEnd, StartWorkspace.Cost[IndexEnd]);
+			}
+		}
+
+		const int32 Id = EntranceIds[Index];
+		if (Id == -1) continue;
+
+		const int32 Cluster = GetCluster(Grid, Index);
+		const FHexCluster& ClusterData = Clusters[Cluster];
+		const int32 Num = ClusterData.Entrances.Num();
+
+		// Se procesan las entradas del mismo cluster y las de los clusters vecinos
+		for (int32 j = 0; j < Num; ++j)
+		{
+			const int32 Distance = ClusterData.Distances[Id * Num + j];
+			if (Distance >= 0) Relax(Index, ClusterData.Entrances[j], Cost + Distance);
+		}
+
+		for (const int32 Link : ClusterData.Links[Id]) Relax(Index, Link, Cost + Grid.Costs[Link]);
+
+		// Desde las entradas del cluster de destino se puede llegar al destino
+		if (Cluster == GoalCluster && Index != IndexEnd && GoalWorkspace.IsVisited(Index))
+		{
+			Relax(Index, IndexEnd, Cost + GoalWorkspace.Cost[Index] - Grid.Costs[Index] + Grid.Costs[IndexEnd]);
+		}
+	}
+
+	if (!Found) return false;
+
+	// Se obtienen los nodos del camino abstracto desde el inicio hasta el destino
+	TArray<int32> Nodes;
+	for (int32 Index = IndexEnd; Index != -1; Index = AbstractWorkspace.Parent[Index]) Nodes.Add(Index);
+	Algo::Reverse(Nodes);
+
+	// Se unen los caminos de cada tramo del camino abstracto
+	for (int32 i = 1; i < Nodes.Num(); ++i)
+	{
+		const int32 From = Nodes[i - 1];
+		const int32 To = Nodes[i];
+
+		if (GetCluster(Grid, From) != GetCluster(Grid, To)) OutPath.Add(To);
+		else if (From == IndexIni) AppendPath(StartWorkspace, IndexIni, To, OutPath);
+		else if (To == IndexEnd)
+		{
+			// El camino de la busqueda desde el destino se recorre en sentido inverso
+			for (int32 Index = GoalWorkspace.Parent[From]; Index != -1; Index = GoalWorkspace.Parent[Index])
+			{
+				OutPath.Add(Index);
+			}
+		}
+		else
+		{
+			const FHexCluster& ClusterData = Clusters[GetCluster(Grid, From)];
+			OutPath.Append(ClusterData.Paths[EntranceIds[From] * ClusterData.Entrances.Num() + EntranceIds[To]]);
+		}
+	}
+
+	return true;
+}
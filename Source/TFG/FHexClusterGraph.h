@@ -0,0 +1,220 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FPathWorkspace.h"
+#include "FTileGrid.h"
+
+/**
+ * Estructura que almacena un nodo de las busquedas del grafo de clusters junto con su prioridad
+ */
+struct FHexClusterNode
+{
+	/**
+	 * Posicion en el Array1D de la casilla
+	 */
+	int32 Index;
+
+	/**
+	 * Prioridad del nodo, menor es mas prioritario
+	 */
+	int32 Priority;
+
+	bool operator<(const FHexClusterNode& Other) const { return Priority < Other.Priority; }
+};
+
+/**
+ * Estructura que almacena la informacion de un cluster del mapa: sus casillas de entrada y los caminos precalculados
+ * entre ellas dentro del propio cluster
+ */
+struct FHexCluster
+{
+	/**
+	 * Posicion en el Array1D de las casillas de entrada del cluster
+	 */
+	TArray<int32> Entrances;
+
+	/**
+	 * Para cada entrada, posicion en el Array1D de las entradas de los clusters vecinos a las que se puede pasar
+	 * directamente
+	 */
+	TArray<TArray<int32, TInlineAllocator<2>>> Links;
+
+	/**
+	 * Coste de ir de cada entrada a cada otra entrada dentro del cluster (Entrances.Num() x Entrances.Num()), -1 si
+	 * no existe camino
+	 */
+	TArray<int32> Distances;
+
+	/**
+	 * Camino entre cada pareja de entradas. No incluye la casilla inicial pero si la final
+	 */
+	TArray<TArray<int32>> Paths;
+
+	/**
+	 * Si el terreno del cluster ha cambiado y deben recalcularse sus entradas y caminos
+	 */
+	bool Dirty = true;
+};
+
+/**
+ * Clase que implementa la busqueda jerarquica de caminos (HPA*) sobre el mapa. El mapa se divide en clusters de
+ * ClusterSize x ClusterSize casillas, se calculan las entradas entre clusters vecinos y los costes de moverse entre
+ * entradas dentro de cada cluster a partir del coste de las casillas.
+ * 
+ * La busqueda se realiza primero sobre el grafo abstracto de entradas y despues se unen los caminos precalculados.
+ * Solo tiene en cuenta el terreno, por lo que los elementos del mapa deben considerarse al refinar el camino. Los
+ * clusters modificados se recalculan de forma perezosa en la siguiente busqueda
+ */
+class FHexClusterGraph
+{
+public:
+	/**
+	 * Numero de filas y columnas de casillas de cada cluster
+	 */
+	static constexpr int32 ClusterSize = 8;
+
+	/**
+	 * Numero de parejas de casillas de frontera consecutivas que comparten una misma entrada
+	 */
+	static constexpr int32 EntranceSpacing = 4;
+
+	/**
+	 * Metodo que inicializa los clusters para la rejilla dada. Todos los clusters quedan pendientes de calcularse
+	 * 
+	 * @param Grid Rejilla de casillas del mapa
+	 */
+	void Init(const FTileGrid& Grid);
+
+	/**
+	 * Metodo que marca como modificado el cluster que contiene la casilla dada
+	 * 
+	 * @param Grid Rejilla de casillas del mapa
+	 * @param Index Posicion en el Array1D de la casilla modificada
+	 */
+	void MarkDirty(const FTileGrid& Grid, const int32 Index);
+
+	/**
+	 * Metodo que calcula un camino aproximado entre dos casillas sobre el grafo de clusters
+	 * 
+	 * @param Grid Rejilla de casillas del mapa
+	 * @param IndexIni Posicion en el Array1D de la casilla inicial
+	 * @param IndexEnd Posicion en el Array1D de la casilla de destino
+	 * @param OutPath Camino calculado como posiciones en el Array1D, sin incluir la casilla inicial
+	 * @return Si se ha encontrado un camino
+	 */
+	bool FindPath(const FTileGrid& Grid, const int32 IndexIni, const int32 IndexEnd, TArray<int32>& OutPath);
+
+private:
+	/**
+	 * Numero de filas y columnas de clusters
+	 */
+	int32 ClusterRows = 0;
+	int32 ClusterCols = 0;
+
+	/**
+	 * Clusters del mapa
+	 */
+	TArray<FHexCluster> Clusters;
+
+	/**
+	 * Indice de la entrada de cada casilla dentro de su cluster, -1 si no es una entrada
+	 */
+	TArray<int32> EntranceIds;
+
+	/**
+	 * Si existe algun cluster pendiente de recalcularse
+	 */
+	bool HasDirty = false;
+
+	/**
+	 * Espacios de trabajo de las busquedas locales y de la busqueda abstracta
+	 */
+	FPathWorkspace LocalWorkspace;
+	FPathWorkspace StartWorkspace;
+	FPathWorkspace GoalWorkspace;
+	FPathWorkspace AbstractWorkspace;
+
+	//----------------------------------------------------------------------------------------------------------------//
+
+	/**
+	 * Metodo privado que obtiene el cluster al que pertenece una casilla
+	 * 
+	 * @param Grid Rejilla de casillas del mapa
+	 * @param Index Posicion en el Array1D
+	 * @return Indice del cluster
+	 */
+	int32 GetCluster(const FTileGrid& Grid, const int32 Index) const
+	{
+		return Index / Grid.Cols / ClusterSize * ClusterCols + Index % Grid.Cols / ClusterSize;
+	}
+
+	/**
+	 * Metodo privado que aplica la funcion dada a la posicion en el Array1D de cada casilla de un cluster
+	 * 
+	 * @param Grid Rejilla de casillas del mapa
+	 * @param Cluster Indice del cluster
+	 * @param Function Funcion a aplicar sobre cada casilla
+	 */
+	template <typename FunctionType>
+	void ForEachTileInCluster(const FTileGrid& Grid, const int32 Cluster, FunctionType&& Function) const
+	{
+		const int32 RowIni = Cluster / ClusterCols * ClusterSize;
+		const int32 ColIni = Cluster % ClusterCols * ClusterSize;
+		const int32 RowEnd = FMath::Min(RowIni + ClusterSize, Grid.Rows);
+		const int32 ColEnd = FMath::Min(ColIni + ClusterSize, Grid.Cols);
+
+		for (int32 Row = RowIni; Row < RowEnd; ++Row)
+		{
+			for (int32 Col = ColIni; Col < ColEnd; ++Col) Function(Row * Grid.Cols + Col);
+		}
+	}
+
+	/**
+	 * Metodo privado que recalcula las entradas y caminos de los clusters modificados y de sus vecinos
+	 * 
+	 * @param Grid Rejilla de casillas del mapa
+	 */
+	void Rebuild(const FTileGrid& Grid);
+
+	/**
+	 * Metodo privado que anade una entrada a un cluster o, si ya existe, anade el enlace con la entrada vecina
+	 * 
+	 * @param Cluster Indice del cluster
+	 * @param Tile Posicion en el Array1D de la entrada
+	 * @param Partner Posicion en el Array1D de la entrada del cluster vecino
+	 */
+	void AddEntrance(const int32 Cluster, const int32 Tile, const int32 Partner);
+
+	/**
+	 * Metodo privado que calcula los costes y caminos entre todas las entradas de un cluster
+	 * 
+	 * @param Grid Rejilla de casillas del mapa
+	 * @param Cluster Indice del cluster
+	 */
+	void BuildIntraEdges(const FTileGrid& Grid, const int32 Cluster);
+
+	/**
+	 * Metodo privado que calcula el coste de llegar desde una casilla a todas las casillas de su cluster (Dijkstra)
+	 * 
+	 * @param Grid Rejilla de casillas del mapa
+	 * @param Cluster Indice del cluster
+	 * @param Start Posicion en el Array1D de la casilla inicial
+	 * @param Workspace Espacio de trabajo en el que se almacenan los resultados
+	 */
+	void SearchCluster(const FTileGrid& Grid, const int32 Cluster, const int32 Start,
+	                   FPathWorkspace& Workspace) const;
+
+	/**
+	 * Metodo estatico privado que anade al array dado el camino almacenado en un espacio de trabajo, sin incluir la
+	 * casilla inicial
+	 * 
+	 * @param Workspace Espacio de trabajo de la busqueda
+	 * @param Start Posicion en el Array1D de la casilla inicial
+	 * @param End Posicion en el Array1D de la casilla final
+	 * @param OutPath Array al que se anade el camino
+	 */
+	static void AppendPath(const FPathWorkspace& Workspace, const int32 Start, const int32 End,
+	                       TArray<int32>& OutPath);
+};
@@ -0,0 +1,61 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FInfluenceMap.h"
+
+#include "LibraryTileMap.h"
+
+void FInfluenceMap::Build(const FTileGrid& Grid, const TArray<FInfluenceSource>& Friendly,
+                          const TArray<FInfluenceSource>& Enemies)
+{
+	const int32 NumTiles = Grid.Num();
+	Support.Init(0.0, NumTiles);
+	Threat.Init(0.0, NumTiles);
+	Control.SetNumUninitialized(NumTiles);
+	Safety.SetNumUninitialized(NumTiles);
+
+	Propagate(Grid, Friendly, Support);
+	Propagate(Grid, Enemies, Threat);
+
+	// Se combinan las capas en un recorrido lineal de los arrays, que el compilador puede vectorizar
+	const float* SupportData = Support.GetData();
+	const float* ThreatData = Threat.GetData();
+	float* ControlData = Control.GetData();
+	float* SafetyData = Safety.GetData();
+	for (int32 Index = 0; Index < NumTiles; ++Index)
+	{
+		ControlData[Index] = SupportData[Index] - ThreatData[Index];
+		SafetyData[Index] = SupportData[Index] - SafetyThreatWeight * ThreatData[Index];
+	}
+}
+
+float FInfluenceMap::GetInfluence(const FTileGrid& Grid, const FInfluenceSource& Source, const int32 Index)
+{
+	if (!Grid.IsValidIndex(Source.Index) || !Grid.IsValidIndex(Index) || Source.Strength <= 0.0) return 0.0;
+
+	const int32 Ring = ULibraryTileMap::GetDistanceToElement(Grid.GetPos(Source.Index), Grid.GetPos(Index));
+	return Ring <= Radius ? Source.Strength * FMath::Pow(Decay, Ring) : 0.0;
+}
+
+//--------------------------------------------------------------------------------------------------------------------//
+
+void FInfluenceMap::Propagate(const FTileGrid& Grid, const TArray<FInfluenceSource>& Sources, TArray<float>& Layer)
+{
+	// Se precalcula la atenuacion de cada anillo
+	float RingDecay[Radius + 1];
+	RingDecay[0] = 1.0;
+	for (int32 Ring = 1; Ring <= Radius; ++Ring) RingDecay[Ring] = RingDecay[Ring - 1] * Decay;
+
+	// Se acumula la fuerza atenuada de cada elemento en las casillas a su alcance
+	const FIntPoint MapSize = FIntPoint(Grid.Rows, Grid.Cols);
+	for (const FInfluenceSource& Source : Sources)
+	{
+		if (!Grid.IsValidIndex(Source.Index) || Source.Strength <= 0.0) continue;
+
+		const FIntPoint SourcePos = Grid.GetPos(Source.Index);
+		ULibraryTileMap::ForEachTileInSpiral(SourcePos, Radius, MapSize, [&](const FIntPoint& Pos, const int32 Ring)
+		{
+			Layer[Grid.GetIndex(Pos)] += Source.Strength * RingDecay[Ring];
+		});
+	}
+}
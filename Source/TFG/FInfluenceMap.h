@@ -0,0 +1,138 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FTileGrid.h"
+
+/**
+ * Estructura que almacena un elemento que ejerce influencia sobre las casillas cercanas
+ */
+struct FInfluenceSource
+{
+	/**
+	 * Posicion en el Array1D del elemento
+	 */
+	int32 Index;
+
+	/**
+	 * Fuerza del elemento, que se atenua con la distancia
+	 */
+	float Strength;
+};
+
+/**
+ * Clase que almacena los mapas de influencia de una faccion. Cada elemento propio o enemigo propaga su fuerza por las
+ * casillas cercanas atenuandose con la distancia, y a partir de ambas influencias se obtienen tres capas:
+ *		* Amenaza: influencia de los elementos de las facciones en guerra
+ *		* Control: diferencia entre la influencia propia y la amenaza, positiva en las zonas dominadas
+ *		* Seguridad: igual que el control pero penalizando mas la amenaza, para elegir las casillas a las que huir
+ * 
+ * Las capas se calculan una vez por turno en arrays contiguos indexados por la posicion de la casilla en el Array1D,
+ * de forma que las consultas son O(1)
+ */
+class FInfluenceMap
+{
+public:
+	/**
+	 * Distancia maxima a la que un elemento ejerce influencia
+	 */
+	static constexpr int32 Radius = 6;
+
+	/**
+	 * Factor por el que se multiplica la influencia en cada anillo
+	 */
+	static constexpr float Decay = 0.7;
+
+	/**
+	 * Peso de la amenaza en la capa de seguridad
+	 */
+	static constexpr float SafetyThreatWeight = 2.0;
+
+	/**
+	 * Coste de movimiento que se anade a un enemigo objetivo por cada punto de amenaza de su casilla, de forma que se
+	 * prefieren los enemigos con menos apoyo aunque esten algo mas lejos
+	 */
+	static constexpr float TargetThreatCost = 0.25;
+
+	/**
+	 * Metodo que calcula todas las capas a partir de los elementos propios y enemigos
+	 * 
+	 * @param Grid Rejilla de casillas del mapa
+	 * @param Friendly Elementos propios
+	 * @param Enemies Elementos de las facciones en guerra
+	 */
+	void Build(const FTileGrid& Grid, const TArray<FInfluenceSource>& Friendly,
+	           const TArray<FInfluenceSource>& Enemies);
+
+	/**
+	 * Metodo que verifica si las capas se han calculado para la rejilla dada
+	 * 
+	 * @param Grid Rejilla de casillas del mapa
+	 * @return Si las capas tienen el tamano de la rejilla
+	 */
+	bool IsInitialized(const FTileGrid& Grid) const { return Threat.Num() == Grid.Num() && Grid.Num() > 0; }
+
+	/**
+	 * Metodo que devuelve la amenaza de una casilla
+	 * 
+	 * @param Index Posicion en el Array1D
+	 * @return Influencia enemiga sobre la casilla
+	 */
+	float GetThreat(const int32 Index) const { return Threat.IsValidIndex(Index) ? Threat[Index] : 0.0; }
+
+	/**
+	 * Metodo que devuelve el control de una casilla
+	 * 
+	 * @param Index Posicion en el Array1D
+	 * @return Influencia propia menos amenaza
+	 */
+	float GetControl(const int32 Index) const { return Control.IsValidIndex(Index) ? Control[Index] : 0.0; }
+
+	/**
+	 * Metodo que devuelve la seguridad de una casilla
+	 * 
+	 * @param Index Posicion en el Array1D
+	 * @return Influencia propia menos la amenaza ponderada
+	 */
+	float GetSafety(const int32 Index) const { return Safety.IsValidIndex(Index) ? Safety[Index] : 0.0; }
+
+	/**
+	 * Metodo que devuelve el coste adicional de elegir como objetivo al enemigo de una casilla segun su apoyo
+	 * 
+	 * @param Index Posicion en el Array1D
+	 * @return Coste de movimiento equivalente a la amenaza de la casilla
+	 */
+	int32 GetTargetCost(const int32 Index) const { return FMath::RoundToInt(GetThreat(Index) * TargetThreatCost); }
+
+	/**
+	 * Metodo estatico que calcula la influencia que ejerce un elemento sobre una casilla. Permite descontar de las
+	 * capas la aportacion de un elemento concreto
+	 * 
+	 * @param Grid Rejilla de casillas del mapa
+	 * @param Source Elemento que ejerce influencia
+	 * @param Index Posicion en el Array1D de la casilla
+	 * @return Fuerza del elemento atenuada con la distancia, 0 si la casilla esta fuera de su alcance
+	 */
+	static float GetInfluence(const FTileGrid& Grid, const FInfluenceSource& Source, const int32 Index);
+
+private:
+	/**
+	 * Capas de influencia de cada casilla
+	 */
+	TArray<float> Support;
+	TArray<float> Threat;
+	TArray<float> Control;
+	TArray<float> Safety;
+
+	//----------------------------------------------------------------------------------------------------------------//
+
+	/**
+	 * Metodo estatico privado que anade a una capa la influencia de los elementos dados
+	 * 
+	 * @param Grid Rejilla de casillas del mapa
+	 * @param Sources Elementos que ejercen influencia
+	 * @param Layer Capa sobre la que se acumula la influencia
+	 */
+	static void Propagate(const FTileGrid& Grid, const TArray<FInfluenceSource>& Sources, TArray<float>& Layer);
+};
@@ -0,0 +1,33 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FOccupancyIndex.h"
+
+void FOccupancyIndex::Init(const FTileGrid& Grid)
+{
+	BucketRows = FMath::DivideAndRoundUp(Grid.Rows, BucketSize);
+	BucketCols = FMath::DivideAndRoundUp(Grid.Cols, BucketSize);
+	Masks.Init(0, BucketRows * BucketCols);
+
+	for (int32 Index = 0; Index < Grid.Num(); ++Index) Masks[GetBucket(Grid, Index)] |= GetTileMask(Grid, Index);
+}
+
+void FOccupancyIndex::UpdateTile(const FTileGrid& Grid, const int32 Index)
+{
+	if (!Grid.IsValidIndex(Index) || Masks.Num() == 0) return;
+
+	// Se recorren las casillas del cubo, ya que puede haber otros elementos de la misma faccion que la eliminada
+	const FIntPoint Pos = Grid.GetPos(Index);
+	const int32 RowIni = Pos.X / BucketSize * BucketSize;
+	const int32 ColIni = Pos.Y / BucketSize * BucketSize;
+	const int32 RowEnd = FMath::Min(RowIni + BucketSize, Grid.Rows);
+	const int32 ColEnd = FMath::Min(ColIni + BucketSize, Grid.Cols);
+
+	uint64 Mask = 0;
+	for (int32 Row = RowIni; Row < RowEnd; ++Row)
+	{
+		for (int32 Col = ColIni; Col < ColEnd; ++Col) Mask |= GetTileMask(Grid, Row * Grid.Cols + Col);
+	}
+
+	Masks[GetBucket(Grid, Index)] = Mask;
+}
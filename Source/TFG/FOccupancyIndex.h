@@ -0,0 +1,143 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FTileGrid.h"
+#include "LibraryTileMap.h"
+
+/**
+ * Clase que indexa las unidades y asentamientos del mapa por facciones. El mapa se divide en cubos de
+ * BucketSize x BucketSize casillas y cada cubo almacena una mascara con un bit por cada faccion que tiene algun
+ * elemento en el. Las consultas por radio solo recorren las casillas de los cubos en los que hay elementos de alguna
+ * de las facciones buscadas
+ */
+class FOccupancyIndex
+{
+public:
+	/**
+	 * Numero de filas y columnas de casillas de cada cubo
+	 */
+	static constexpr int32 BucketSize = 4;
+
+	/**
+	 * Metodo estatico que obtiene el bit de una faccion. Los elementos sin faccion (-1) emplean el primer bit
+	 * 
+	 * @param Faction Faccion
+	 * @return Mascara con el bit de la faccion, 0 si la faccion no tiene bit asignado
+	 */
+	static uint64 GetFactionMask(const int32 Faction)
+	{
+		return Faction >= -1 && Faction < 63 ? uint64(1) << (Faction + 1) : 0;
+	}
+
+	/**
+	 * Metodo que calcula las mascaras de todos los cubos a partir de la rejilla
+	 * 
+	 * @param Grid Rejilla de casillas del mapa
+	 */
+	void Init(const FTileGrid& Grid);
+
+	/**
+	 * Metodo que recalcula la mascara del cubo de una casilla cuyos elementos han cambiado
+	 * 
+	 * @param Grid Rejilla de casillas del mapa
+	 * @param Index Posicion en el Array1D de la casilla
+	 */
+	void UpdateTile(const FTileGrid& Grid, const int32 Index);
+
+	/**
+	 * Metodo que aplica la funcion dada a cada casilla a distancia menor o igual que la dada de una posicion cuyo
+	 * elemento pertenece a alguna de las facciones de la mascara. La propia posicion no se incluye
+	 * 
+	 * @param Grid Rejilla de casillas del mapa
+	 * @param Center Posicion central en el Array2D
+	 * @param Range Distancia maxima
+	 * @param FactionMask Mascara de las facciones buscadas
+	 * @param Function Funcion a aplicar sobre la posicion en el Array1D de cada casilla
+	 */
+	template <typename FunctionType>
+	void ForEachElementInRange(const FTileGrid& Grid, const FIntPoint& Center, const int32 Range,
+	                           const uint64 FactionMask, FunctionType&& Function) const
+	{
+		if (Range <= 0 || FactionMask == 0 || Masks.Num() == 0) return;
+
+		// La distancia entre casillas es mayor o igual que la diferencia de filas y de columnas, por lo que basta con
+		// recorrer los cubos del rectangulo que contiene el radio
+		const int32 RowIni = FMath::Max(Center.X - Range, 0);
+		const int32 ColIni = FMath::Max(Center.Y - Range, 0);
+		const int32 RowEnd = FMath::Min(Center.X + Range, Grid.Rows - 1);
+		const int32 ColEnd = FMath::Min(Center.Y + Range, Grid.Cols - 1);
+
+		for (int32 BucketRow = RowIni / BucketSize; BucketRow <= RowEnd / BucketSize; ++BucketRow)
+		{
+			for (int32 BucketCol = ColIni / BucketSize; BucketCol <= ColEnd / BucketSize; ++BucketCol)
+			{
+				// Si el cubo no contiene elementos de las facciones buscadas, se omite
+				if ((Masks[BucketRow * BucketCols + BucketCol] & FactionMask) == 0) continue;
+
+				const int32 Row0 = FMath::Max(BucketRow * BucketSize, RowIni);
+				const int32 Col0 = FMath::Max(BucketCol * BucketSize, ColIni);
+				const int32 Row1 = FMath::Min(BucketRow * BucketSize + BucketSize - 1, RowEnd);
+				const int32 Col1 = FMath::Min(BucketCol * BucketSize + BucketSize - 1, ColEnd);
+
+				for (int32 Row = Row0; Row <= Row1; ++Row)
+				{
+					for (int32 Col = Col0; Col <= Col1; ++Col)
+					{
+						const int32 Index = Row * Grid.Cols + Col;
+						if (!Grid.HasElement(Index) || (GetFactionMask(Grid.GetElementOwner(Index)) & FactionMask) == 0)
+						{
+							continue;
+						}
+
+						const int32 Distance = ULibraryTileMap::GetDistanceToElement(Center, FIntPoint(Row, Col));
+						if (Distance > 0 && Distance <= Range) Function(Index);
+					}
+				}
+			}
+		}
+	}
+
+private:
+	/**
+	 * Numero de filas y columnas de cubos
+	 */
+	int32 BucketRows = 0;
+	int32 BucketCols = 0;
+
+	/**
+	 * Mascara de las facciones con algun elemento en cada cubo
+	 */
+	TArray<uint64> Masks;
+
+	//----------------------------------------------------------------------------------------------------------------//
+
+	/**
+	 * Metodo privado que obtiene el cubo al que pertenece una casilla
+	 * 
+	 * @param Grid Rejilla de casillas del mapa
+	 * @param Index Posicion en el Array1D
+	 * @return Indice del cubo
+	 */
+	int32 GetBucket(const FTileGrid& Grid, const int32 Index) const
+	{
+		return Index / Grid.Cols / BucketSize * BucketCols + Index % Grid.Cols / BucketSize;
+	}
+
+	/**
+	 * Metodo estatico privado que obtiene la mascara de las facciones con elementos en una casilla
+	 * 
+	 * @param Grid Rejilla de casillas del mapa
+	 * @param Index Posicion en el Array1D
+	 * @return Mascara de las facciones de la unidad y el asentamiento de la casilla
+	 */
+	static uint64 GetTileMask(const FTileGrid& Grid, const int32 Index)
+	{
+		uint64 Mask = 0;
+		if (Grid.HasUnit(Index)) Mask |= GetFactionMask(Grid.UnitOwners[Index]);
+		if (Grid.HasSettlement(Index)) Mask |= GetFactionMask(Grid.SettlementOwners[Index]);
+
+		return Mask;
+	}
+};
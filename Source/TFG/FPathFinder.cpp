@@ -0,0 +1,618 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FPathFinder.h"
+
+#include "Algo/Reverse.h"
+#include "TPriorityQueue.h"
+
+/**
+ * Estructura que almacena un nodo de las busquedas de caminos junto con su prioridad
+ */
+struct FPathNode
+{
+	/**
+	 * Posicion en el Array1D de la casilla
+	 */
+	int32 Index;
+
+	/**
+	 * Prioridad del nodo, menor es mas prioritario
+	 */
+	int32 Priority;
+
+	/**
+	 * Coste acumulado empleado para desempatar, a igual prioridad se expande antes el de mayor valor
+	 */
+	int32 Depth = 0;
+
+	bool operator<(const FPathNode& Other) const
+	{
+		return Priority < Other.Priority || (Priority == Other.Priority && Depth > Other.Depth);
+	}
+};
+
+/**
+ * Estructura que almacena un estado de la busqueda por turnos junto con su prioridad, que se compara de forma
+ * lexicografica: primero el numero de turnos estimado y despues el coste estimado
+ */
+struct FTurnPathNode
+{
+	/**
+	 * Posicion del estado en el espacio de trabajo
+	 */
+	int32 State;
+
+	/**
+	 * Numero de turnos estimado hasta el destino
+	 */
+	int32 Turns;
+
+	/**
+	 * Coste de movimiento estimado hasta el destino
+	 */
+	int32 Cost;
+
+	bool operator<(const FTurnPathNode& Other) const
+	{
+		return Turns < Other.Turns || (Turns == Other.Turns && Cost < Other.Cost);
+	}
+};
+
+bool FPathFinder::ComputePath(const FTileGrid& Grid, const FPathQuery& Query, FPathWorkspace& Workspace,
+                              TArray<FMovement>& OutPath, const EPathSearchMode SearchMode)
+{
+	OutPath.Reset();
+
+	// Se comprueba que la consulta sea valida
+	if (!Grid.IsValidIndex(Query.IndexIni) || !Grid.IsValidIndex(Query.IndexEnd)) return false;
+	if (Query.IndexIni == Query.IndexEnd) return false;
+
+	// La busqueda por turnos necesita su propio espacio de trabajo
+	if (SearchMode == EPathSearchMode::MinTurns)
+	{
+		FTurnPathWorkspace TurnWorkspace;
+		const bool Found = ComputePathByTurns(Grid, Query, TurnWorkspace, OutPath);
+		Workspace.NumExpanded = TurnWorkspace.NumExpanded;
+		return Found;
+	}
+
+	if (!SearchPath(Grid, Query.IndexIni, Query.IndexEnd, Query.Faction, Query.IsGoalEnemy, Workspace, OutPath,
+	                SearchMode))
+	{
+		return false;
+	}
+
+	// Se actualiza el numero de turnos en alcanzar cada casilla del camino
+	ULibraryTileMap::UpdatePathTurns(OutPath, Query.BaseMovementPoints, Query.MovementPoints);
+
+	return true;
+}
+
+bool FPathFinder::ComputePathByTurns(const FTileGrid& Grid, const FPathQuery& Query, FTurnPathWorkspace& Workspace,
+                                     TArray<FMovement>& OutPath)
+{
+	OutPath.Reset();
+
+	// Se comprueba que la consulta sea valida
+	if (!Grid.IsValidIndex(Query.IndexIni) || !Grid.IsValidIndex(Query.IndexEnd)) return false;
+	if (Query.IndexIni == Query.IndexEnd) return false;
+
+	const int32 BaseMovementPoints = FMath::Max(Query.BaseMovementPoints, 1);
+	const int32 NumPoints = BaseMovementPoints + 1;
+	const FIntPoint PosEnd = Grid.GetPos(Query.IndexEnd);
+
+	// Se calculan las cotas inferiores del coste y de los turnos adicionales que faltan para llegar al destino
+	auto GetHeuristic = [&](const int32 Index, const int32 Points, int32& OutTurns)
+	{
+		const int32 Distance = ULibraryTileMap::GetDistanceToElement(Grid.GetPos(Index), PosEnd);
+		OutTurns = Distance <= Points ? 0 : FMath::DivideAndRoundUp(Distance - Points, BaseMovementPoints);
+		return Distance;
+	};
+
+	// Se prepara el espacio de trabajo con un estado por cada casilla y cantidad de puntos de movimiento
+	Workspace.InitStates(Grid.Num() * NumPoints);
+	Workspace.NewSearch();
+
+	const int32 StartPoints = FMath::Clamp(Query.MovementPoints, 0, BaseMovementPoints);
+	const int32 StartState = Query.IndexIni * NumPoints + StartPoints;
+	Workspace.SetNode(StartState, 0, -1);
+	Workspace.Turns[StartState] = 1;
+
+	int32 StartTurns;
+	const int32 StartDistance = GetHeuristic(Query.IndexIni, StartPoints, StartTurns);
+
+	TPriorityQueue<FTurnPathNode> Frontier;
+	Frontier.Push(FTurnPathNode{StartState, 1 + StartTurns, StartDistance});
+
+	int32 GoalState = -1;
+	while (!Frontier.IsEmpty())
+	{
+		const FTurnPathNode CurrentNode = Frontier.Pop();
+		const int32 CurrentState = CurrentNode.State;
+		const int32 CurrentIndex = CurrentState / NumPoints;
+		const int32 CurrentPoints = CurrentState % NumPoints;
+		const int32 CurrentTurns = Workspace.Turns[CurrentState];
+		const int32 CurrentCost = Workspace.Cost[CurrentState];
+
+		// Si la entrada ha quedado obsoleta porque se ha encontrado un camino mejor, se descarta
+		int32 HeuristicTurns;
+		const int32 HeuristicCost = GetHeuristic(CurrentIndex, CurrentPoints, HeuristicTurns);
+		if (CurrentNode.Turns != CurrentTurns + HeuristicTurns || CurrentNode.Cost != CurrentCost + HeuristicCost)
+		{
+			continue;
+		}
+
+		++Workspace.NumExpanded;
+
+		// El primer estado del destino que se extrae es el de menor numero de turnos
+		if (CurrentIndex == Query.IndexEnd)
+		{
+			GoalState = CurrentState;
+			break;
+		}
+
+		Grid.ForEachNeighbor(CurrentIndex, [&](const int32 Index)
+		{
+			if (!CanEnterTile(Grid, Index, Query.IndexEnd, Query.Faction, Query.IsGoalEnemy)) return;
+
+			// Si no hay puntos de movimiento suficientes, se entra en la casilla en el siguiente turno. Los puntos
+			// negativos equivalen a 0, ya que cualquier casilla necesita un nuevo turno
+			const int32 TileCost = Grid.Costs[Index];
+			int32 NewTurns = CurrentTurns;
+			int32 NewPoints = CurrentPoints - TileCost;
+			if (TileCost > CurrentPoints)
+			{
+				++NewTurns;
+				NewPoints = FMath::Max(BaseMovementPoints - TileCost, 0);
+			}
+
+			// Si el estado ya se habia alcanzado con menos turnos o con los mismos turnos y menor coste, se omite
+			const int32 NewCost = CurrentCost + TileCost;
+			const int32 NewState = Index * NumPoints + NewPoints;
+			if (Workspace.IsVisited(NewState) && (Workspace.Turns[NewState] < NewTurns ||
+				(Workspace.Turns[NewState] == NewTurns && Workspace.Cost[NewState] <= NewCost)))
+			{
+				return;
+			}
+
+			Workspace.SetNode(NewState, NewCost, CurrentState);
+			Workspace.Turns[NewState] = NewTurns;
+
+			int32 NewHeuristicTurns;
+			const int32 NewHeuristicCost = GetHeuristic(Index, NewPoints, NewHeuristicTurns);
+			Frontier.Push(FTurnPathNode{NewState, NewTurns + NewHeuristicTurns, NewCost + NewHeuristicCost});
+		});
+	}
+
+	if (GoalState == -1) return false;
+
+	// Se reconstruye el camino desde el estado final, incluyendo el turno en el que se alcanza cada casilla
+	for (int32 State = GoalState; State != StartState; State = Workspace.Parent[State])
+	{
+		const int32 Index = State / NumPoints;
+		OutPath.Add(FMovement(Grid.GetPos(Index), Grid.Costs[Index], Workspace.Cost[State], Workspace.Turns[State]));
+	}
+
+	Algo::Reverse(OutPath);
+	return true;
+}
+
+void FPathFinder::ComputeReachability(const FTileGrid& Grid, const int32 IndexIni, const int32 Faction,
+                                      const int32 BaseMovementPoints, const int32 MovementPoints, const int32 MaxTurns,
+                                      FTurnPathWorkspace& Workspace, FReachabilityMap& OutMap)
+{
+	// Se almacenan los datos con los que se calcula el mapa para poder validarlo mas adelante
+	OutMap.IndexIni = IndexIni;
+	OutMap.Faction = Faction;
+	OutMap.BaseMovementPoints = BaseMovementPoints;
+	OutMap.MovementPoints = MovementPoints;
+	OutMap.MaxTurns = FMath::Clamp(MaxTurns, 0, FReachabilityMap::Unreachable - 1);
+	OutMap.Turns.Init(FReachabilityMap::Unreachable, Grid.Num());
+
+	if (!Grid.IsValidIndex(IndexIni)) return;
+	OutMap.Turns[IndexIni] = 0;
+
+	const int32 BasePoints = FMath::Max(BaseMovementPoints, 1);
+	const int32 NumPoints = BasePoints + 1;
+
+	// Se prepara el espacio de trabajo con un estado por cada casilla y cantidad de puntos de movimiento
+	Workspace.InitStates(Grid.Num() * NumPoints);
+	Workspace.NewSearch();
+
+	const int32 StartState = IndexIni * NumPoints + FMath::Clamp(MovementPoints, 0, BasePoints);
+	Workspace.SetNode(StartState, 0, -1);
+	Workspace.Turns[StartState] = 1;
+
+	// Los estados se extraen por orden de turnos y coste, por lo que el primero de cada casilla tiene el menor turno
+	TPriorityQueue<FTurnPathNode> Frontier;
+	Frontier.Push(FTurnPathNode{StartState, 1, 0});
+
+	while (!Frontier.IsEmpty())
+	{
+		const FTurnPathNode CurrentNode = Frontier.Pop();
+		const int32 CurrentState = CurrentNode.State;
+		const int32 CurrentTurns = Workspace.Turns[CurrentState];
+		const int32 CurrentCost = Workspace.Cost[CurrentState];
+
+		// Si la entrada ha quedado obsoleta porque se ha encontrado un camino mejor, se descarta
+		if (CurrentNode.Turns != CurrentTurns || CurrentNode.Cost != CurrentCost) continue;
+
+		++Workspace.NumExpanded;
+
+		const int32 CurrentIndex = CurrentState / NumPoints;
+		const int32 CurrentPoints = CurrentState % NumPoints;
+		if (OutMap.Turns[CurrentIndex] == FReachabilityMap::Unreachable) OutMap.Turns[CurrentIndex] = CurrentTurns;
+
+		Grid.ForEachNeighbor(CurrentIndex, [&](const int32 Index)
+		{
+			if (!Grid.IsAccesible(Index)) return;
+
+			// Si no hay puntos de movimiento suficientes, se entra en la casilla en el siguiente turno
+			const int32 TileCost = Grid.Costs[Index];
+			int32 NewTurns = CurrentTurns;
+			int32 NewPoints = CurrentPoints - TileCost;
+			if (TileCost > CurrentPoints)
+			{
+				++NewTurns;
+				NewPoints = FMath::Max(BasePoints - TileCost, 0);
+			}
+
+			if (NewTurns > OutMap.MaxTurns) return;
+
+			// Las casillas con elementos de otras facciones se marcan como alcanzables sin continuar la busqueda
+			if (!CanEnterTile(Grid, Index, -1, Faction, false))
+			{
+				if (Grid.GetElementOwner(Index) != Faction)
+				{
+					OutMap.Turns[Index] = FMath::Min<uint8>(OutMap.Turns[Index], NewTurns);
+				}
+
+				return;
+			}
+
+			// Si el estado ya se habia alcanzado con menos turnos o con los mismos turnos y menor coste, se omite
+			const int32 NewCost = CurrentCost + TileCost;
+			const int32 NewState = Index * NumPoints + NewPoints;
+			if (Workspace.IsVisited(NewState) && (Workspace.Turns[NewState] < NewTurns ||
+				(Workspace.Turns[NewState] == NewTurns && Workspace.Cost[NewState] <= NewCost)))
+			{
+				return;
+			}
+
+			Workspace.SetNode(NewState, NewCost, CurrentState);
+			Workspace.Turns[NewState] = NewTurns;
+			Frontier.Push(FTurnPathNode{NewState, NewTurns, NewCost});
+		});
+	}
+}
+
+bool FPathFinder::SearchPath(const FTileGrid& Grid, const int32 IndexIni, const int32 IndexEnd, const int32 Faction,
+                             const bool IsGoalEnemy, FPathWorkspace& Workspace, TArray<FMovement>& OutPath,
+                             const EPathSearchMode SearchMode)
+{
+	if (SearchMode == EPathSearchMode::Bidirectional)
+	{
+		return SearchPathBidirectional(Grid, IndexIni, IndexEnd, Faction, IsGoalEnemy, Workspace, OutPath);
+	}
+
+	OutPath.Reset();
+	const FIntPoint PosEnd = Grid.GetPos(IndexEnd);
+
+	// Se determina si se rompen las simetrias. En modo automatico solo se hace si la region de la casilla inicial o
+	// de destino tiene coste uniforme, que es donde aparecen los caminos simetricos
+	const bool BreakSymmetries = SearchMode == EPathSearchMode::SymmetryBreaking ||
+		(SearchMode == EPathSearchMode::Auto && (IsUniformRegion(Grid, IndexIni) || IsUniformRegion(Grid, IndexEnd)));
+
+	// Se prepara el espacio de trabajo de la busqueda. Almacena, para cada casilla, el coste de llegar a ella y
+	// desde cual se ha llegado
+	Workspace.Init(Grid.Num());
+	Workspace.NewSearch();
+	Workspace.SetNode(IndexIni, 0, -1);
+
+	// Se crea una lista con prioridad para almacenar los nodos por visitar ordenados de mayor a menor prioridad
+	// teniendo en cuenta que la prioridad se basa en la cercania al objetivo y el coste
+	//
+	// Inicialmente, se inserta el nodo inicial
+	TPriorityQueue<FPathNode> Frontier;
+	Frontier.Reserve(Grid.Num());
+	Frontier.Push(FPathNode{IndexIni, 0});
+
+	// Se procesan nodos mientras sigan quedando
+	while (!Frontier.IsEmpty())
+	{
+		// Se obtiene el nodo con la mayor prioridad
+		const FPathNode CurrentNode = Frontier.Pop();
+		const int32 CurrentIndex = CurrentNode.Index;
+		const int32 CurrentCost = Workspace.Cost[CurrentIndex];
+
+		// Si la entrada ha quedado obsoleta porque se ha encontrado un camino mejor, se descarta (eliminacion
+		// perezosa de la cola con prioridad)
+		if (CurrentNode.Priority > CurrentCost + ULibraryTileMap::GetDistanceToElement(Grid.GetPos(CurrentIndex),
+		                                                                              PosEnd))
+		{
+			continue;
+		}
+
+		++Workspace.NumExpanded;
+
+		// Se comprueba si se ha llegado al destino
+		if (CurrentIndex == IndexEnd)
+		{
+			// Se procesan todos los nodos del espacio de trabajo que nos permite conocer el camino de vuelta
+			// a la posicion inicial desde el objetivo
+			for (int32 Index = IndexEnd; Index != IndexIni; Index = Workspace.Parent[Index])
+			{
+				// Se anade el nodo actual al camino a devolver
+				OutPath.Add(FMovement(Grid.GetPos(Index), Grid.Costs[Index], Workspace.Cost[Index]));
+			}
+
+			// Se invierte el camino para que comience en la posicion inicial
+			Algo::Reverse(OutPath);
+			return true;
+		}
+
+		// Si se rompen las simetrias, se obtienen los vecinos de la casilla previa. Cualquiera de ellos se alcanza
+		// desde la casilla previa con menor coste que pasando por la actual, por lo que no es necesario generarlos
+		const int32 Parent = Workspace.Parent[CurrentIndex];
+		const int32* ParentNeighbors = BreakSymmetries && Parent != -1
+			                               ? Grid.Neighbors.GetData() + Parent * HexNeighborsNum
+			                               : nullptr;
+
+		// Se procesan los vecinos de la casilla actual empleando la tabla precalculada
+		Grid.ForEachNeighbor(CurrentIndex, [&](const int32 Index)
+		{
+			// Si no se puede entrar en el vecino o se alcanza mejor desde la casilla previa, se omite
+			if (Index == Parent || !CanEnterTile(Grid, Index, IndexEnd, Faction, IsGoalEnemy)) return;
+			if (ParentNeighbors)
+			{
+				for (int32 i = 0; i < HexNeighborsNum; ++i) if (ParentNeighbors[i] == Index) return;
+			}
+
+			// Se calcula el coste de llegar a esta casilla junto con el coste de movimiento de la propia casilla y,
+			// si el nodo no se habia procesado previamente o el nuevo coste es menor, se actualizan los valores de
+			// coste, prioridad y procedencia
+			const int32 NewCost = CurrentCost + Grid.Costs[Index];
+			if (NewCost < Workspace.GetCost(Index))
+			{
+				Workspace.SetNode(Index, NewCost, CurrentIndex);
+
+				const int32 Priority = NewCost + ULibraryTileMap::GetDistanceToElement(Grid.GetPos(Index), PosEnd);
+				Frontier.Push(FPathNode{Index, Priority, BreakSymmetries ? NewCost : 0});
+			}
+		});
+	}
+
+	return false;
+}
+
+bool FPathFinder::SearchPathBidirectional(const FTileGrid& Grid, const int32 IndexIni, const int32 IndexEnd,
+                                          const int32 Faction, const bool IsGoalEnemy, FPathWorkspace& Workspace,
+                                          TArray<FMovement>& OutPath)
+{
+	OutPath.Reset();
+	const FIntPoint PosIni = Grid.GetPos(IndexIni);
+	const FIntPoint PosEnd = Grid.GetPos(IndexEnd);
+
+	// Si no se puede entrar en el destino, no existe camino
+	if (!CanEnterTile(Grid, IndexEnd, IndexEnd, Faction, IsGoalEnemy)) return false;
+
+	// Se preparan ambas busquedas. La directa almacena el coste desde el origen y la inversa el coste hasta el destino
+	Workspace.Init(Grid.Num());
+	Workspace.InitReverse();
+	Workspace.NewSearch();
+	Workspace.SetNode(IndexIni, 0, -1);
+	Workspace.SetReverseNode(IndexEnd, 0, -1);
+
+	TPriorityQueue<FPathNode> ForwardFrontier;
+	TPriorityQueue<FPathNode> ReverseFrontier;
+	ForwardFrontier.Push(FPathNode{IndexIni, ULibraryTileMap::GetDistanceToElement(PosIni, PosEnd)});
+	ReverseFrontier.Push(FPathNode{IndexEnd, ULibraryTileMap::GetDistanceToElement(PosIni, PosEnd)});
+
+	// Mejor camino encontrado, identificado por la casilla en la que se encuentran ambas busquedas
+	int32 BestCost = MAX_int32;
+	int32 MeetIndex = -1;
+
+	auto UpdateMeeting = [&](const int32 Index)
+	{
+		// Solo se puede pasar por la casilla si se ha alcanzado en la busqueda directa, que verifica que se pueda
+		// entrar en ella
+		if (!Workspace.IsVisited(Index) || !Workspace.IsReverseVisited(Index)) return;
+
+		const int32 Cost = Workspace.Cost[Index] + Workspace.ReverseCost[Index];
+		if (Cost < BestCost)
+		{
+			BestCost = Cost;
+			MeetIndex = Index;
+		}
+	};
+	UpdateMeeting(IndexIni);
+
+	while (!ForwardFrontier.IsEmpty() && !ReverseFrontier.IsEmpty())
+	{
+		// Ningun camino que no se haya encontrado ya puede ser mejor que el coste minimo de cualquiera de las colas
+		const int32 MinForward = ForwardFrontier.Top().Priority;
+		const int32 MinReverse = ReverseFrontier.Top().Priority;
+		if (BestCost <= FMath::Max(MinForward, MinReverse)) break;
+
+		if (MinForward <= MinReverse)
+		{
+			// Se expande la busqueda directa, descartando las entradas obsoletas
+			const FPathNode CurrentNode = ForwardFrontier.Pop();
+			const int32 CurrentIndex = CurrentNode.Index;
+			const int32 CurrentCost = Workspace.Cost[CurrentIndex];
+			if (CurrentNode.Priority > CurrentCost + ULibraryTileMap::GetDistanceToElement(Grid.GetPos(CurrentIndex),
+				PosEnd))
+			{
+				continue;
+			}
+
+			++Workspace.NumExpanded;
+			Grid.ForEachNeighbor(CurrentIndex, [&](const int32 Index)
+			{
+				if (!CanEnterTile(Grid, Index, IndexEnd, Faction, IsGoalEnemy)) return;
+
+				const int32 NewCost = CurrentCost + Grid.Costs[Index];
+				if (NewCost >= Workspace.GetCost(Index)) return;
+
+				Workspace.SetNode(Index, NewCost, CurrentIndex);
+				UpdateMeeting(Index);
+
+				const int32 Priority = NewCost + ULibraryTileMap::GetDistanceToElement(Grid.GetPos(Index), PosEnd);
+				ForwardFrontier.Push(FPathNode{Index, Priority});
+			});
+		}
+		else
+		{
+			// Se expande la busqueda inversa, descartando las entradas obsoletas
+			const FPathNode CurrentNode = ReverseFrontier.Pop();
+			const int32 CurrentIndex = CurrentNode.Index;
+			const int32 CurrentCost = Workspace.ReverseCost[CurrentIndex];
+			if (CurrentNode.Priority > CurrentCost + ULibraryTileMap::GetDistanceToElement(PosIni,
+				Grid.GetPos(CurrentIndex)))
+			{
+				continue;
+			}
+
+			// Solo se puede llegar a esta casilla desde sus vecinos si se puede entrar en ella. La casilla inicial
+			// puede contener la propia unidad, por lo que se alcanza pero no se expande
+			if (CurrentIndex != IndexEnd && !CanEnterTile(Grid, CurrentIndex, IndexEnd, Faction, IsGoalEnemy)) continue;
+
+			++Workspace.NumExpanded;
+			const int32 NewCost = CurrentCost + Grid.Costs[CurrentIndex];
+			Grid.ForEachNeighbor(CurrentIndex, [&](const int32 Index)
+			{
+				if (!Grid.IsAccesible(Index) || NewCost >= Workspace.GetReverseCost(Index)) return;
+
+				Workspace.SetReverseNode(Index, NewCost, CurrentIndex);
+				UpdateMeeting(Index);
+
+				const int32 Priority = NewCost + ULibraryTileMap::GetDistanceToElement(PosIni, Grid.GetPos(Index));
+				ReverseFrontier.Push(FPathNode{Index, Priority});
+			});
+		}
+	}
+
+	if (MeetIndex == -1) return false;
+
+	// Se obtiene el tramo de la busqueda directa, desde la casilla de encuentro hasta el origen
+	TArray<int32> PathIndices;
+	for (int32 Index = MeetIndex; Index != IndexIni; Index = Workspace.Parent[Index]) PathIndices.Add(Index);
+	Algo::Reverse(PathIndices);
+
+	// Se anade el tramo de la busqueda inversa, desde la casilla de encuentro hasta el destino
+	for (int32 Index = Workspace.ReverseParent[MeetIndex]; Index != -1; Index = Workspace.ReverseParent[Index])
+	{
+		PathIndices.Add(Index);
+	}
+
+	int32 TotalCost = 0;
+	for (const int32 Index : PathIndices)
+	{
+		TotalCost += Grid.Costs[Index];
+		OutPath.Add(FMovement(Grid.GetPos(Index), Grid.Costs[Index], TotalCost));
+	}
+
+	return true;
+}
+
+bool FPathFinder::IsUniformRegion(const FTileGrid& Grid, const int32 Index)
+{
+	if (!Grid.IsValidIndex(Index) || !Grid.IsAccesible(Index)) return false;
+
+	bool IsUniform = true;
+	Grid.ForEachNeighbor(Index, [&](const int32 Neighbor)
+	{
+		IsUniform &= !Grid.IsAccesible(Neighbor) || Grid.Costs[Neighbor] == Grid.Costs[Index];
+	});
+
+	return IsUniform;
+}
+
+void FPathFinder::SearchPathsToGoal(const FTileGrid& Grid, const TArray<int32>& Starts, const int32 IndexEnd,
+                                    const int32 Faction, const bool IsGoalEnemy, FPathWorkspace& Workspace)
+{
+	Workspace.Init(Grid.Num());
+	Workspace.NewSearch();
+	Workspace.SetNode(IndexEnd, 0, -1);
+
+	// Se marcan las casillas iniciales para finalizar la busqueda cuando se hayan alcanzado todas
+	TSet<int32> PendingStarts = TSet<int32>(Starts);
+
+	TPriorityQueue<FPathNode> Frontier;
+	Frontier.Push(FPathNode{IndexEnd, 0});
+
+	while (!Frontier.IsEmpty() && PendingStarts.Num() > 0)
+	{
+		const FPathNode CurrentNode = Frontier.Pop();
+		const int32 CurrentIndex = CurrentNode.Index;
+		const int32 CurrentCost = Workspace.Cost[CurrentIndex];
+
+		// Si la entrada ha quedado obsoleta, se descarta
+		if (CurrentNode.Priority > CurrentCost) continue;
+
+		PendingStarts.Remove(CurrentIndex);
+
+		// Solo se puede llegar a esta casilla desde sus vecinos si se puede entrar en ella. Las casillas iniciales
+		// pueden contener la propia unidad, por lo que se alcanzan pero no se expanden
+		if (!CanEnterTile(Grid, CurrentIndex, IndexEnd, Faction, IsGoalEnemy)) continue;
+
+		// El coste de moverse desde un vecino hasta esta casilla es el de la propia casilla
+		const int32 NewCost = CurrentCost + Grid.Costs[CurrentIndex];
+		Grid.ForEachNeighbor(CurrentIndex, [&](const int32 Index)
+		{
+			if (!Grid.IsAccesible(Index) || NewCost >= Workspace.GetCost(Index)) return;
+
+			Workspace.SetNode(Index, NewCost, CurrentIndex);
+			Frontier.Push(FPathNode{Index, NewCost});
+		});
+	}
+}
+
+void FPathFinder::BuildFlowField(const FTileGrid& Grid, const TArray<int32>& Targets, const int32 Faction,
+                                 const bool TargetsAreEnemies, FFlowField& OutField, const TArray<int32>* TargetCosts)
+{
+	OutField.Init(Grid.Num());
+	OutField.Faction = Faction;
+	OutField.TargetsAreEnemies = TargetsAreEnemies;
+
+	// Se insertan todos los objetivos con su coste inicial, 0 si no se proporciona
+	TPriorityQueue<FPathNode> Frontier;
+	for (int32 i = 0; i < Targets.Num(); ++i)
+	{
+		const int32 Target = Targets[i];
+		const int32 TargetCost = TargetCosts && TargetCosts->IsValidIndex(i) ? FMath::Max((*TargetCosts)[i], 0) : 0;
+		if (!Grid.IsValidIndex(Target) || !Grid.IsAccesible(Target) || OutField.Costs[Target] <= TargetCost) continue;
+
+		OutField.Costs[Target] = TargetCost;
+		OutField.Targets[Target] = Target;
+		Frontier.Push(FPathNode{Target, TargetCost});
+	}
+
+	// Se realiza la busqueda inversa desde todos los objetivos a la vez
+	while (!Frontier.IsEmpty())
+	{
+		const FPathNode CurrentNode = Frontier.Pop();
+		const int32 CurrentIndex = CurrentNode.Index;
+		const int32 CurrentCost = OutField.Costs[CurrentIndex];
+
+		// Si la entrada ha quedado obsoleta, se descarta
+		if (CurrentNode.Priority > CurrentCost) continue;
+
+		// Solo se puede llegar a esta casilla desde sus vecinos si es un objetivo o se puede entrar en ella
+		const bool IsTarget = OutField.Targets[CurrentIndex] == CurrentIndex;
+		if (!IsTarget && !CanEnterTile(Grid, CurrentIndex, -1, Faction, false)) continue;
+
+		// El coste de moverse desde un vecino hasta esta casilla es el de la propia casilla
+		const int32 NewCost = CurrentCost + Grid.Costs[CurrentIndex];
+		Grid.ForEachNeighbor(CurrentIndex, [&](const int32 Index)
+		{
+			if (!Grid.IsAccesible(Index) || NewCost >= OutField.Costs[Index]) return;
+
+			OutField.Costs[Index] = NewCost;
+			OutField.Next[Index] = CurrentIndex;
+			OutField.Targets[Index] = OutField.Targets[CurrentIndex];
+			Frontier.Push(FPathNode{Index, NewCost});
+		});
+	}
+}
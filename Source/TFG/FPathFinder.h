@@ -0,0 +1,294 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FFlowField.h"
+#include "FMovement.h"
+#include "FPathWorkspace.h"
+#include "FReachabilityMap.h"
+#include "FTileGrid.h"
+
+/**
+ * Modos de la busqueda de caminos. Todos obtienen caminos de coste optimo, pero difieren en el numero de casillas que
+ * se expanden
+ */
+enum class EPathSearchMode : uint8
+{
+	/**
+	 * Se rompen las simetrias si la region de la casilla inicial o de destino tiene coste uniforme
+	 */
+	Auto,
+	/**
+	 * Busqueda A* sin poda
+	 */
+	Standard,
+	/**
+	 * Busqueda A* con poda de los vecinos alcanzables desde la casilla previa y desempate hacia las casillas mas
+	 * alejadas del origen
+	 */
+	SymmetryBreaking,
+	/**
+	 * Busqueda A* bidireccional, desde la casilla inicial y desde la de destino a la vez. Pensada para caminos largos
+	 */
+	Bidirectional,
+	/**
+	 * Busqueda sobre los estados (casilla, puntos de movimiento restantes) que minimiza el numero de turnos y, a
+	 * igual numero de turnos, el coste de movimiento. Necesita los puntos de movimiento de la consulta, por lo que
+	 * SearchPath lo trata como Standard
+	 */
+	MinTurns
+};
+
+/**
+ * Estructura que almacena una consulta de camino ya resuelta sobre la rejilla de casillas. Todos los datos que
+ * dependen de los actores (faccion en juego, si el destino es enemigo) se obtienen al crearla, de forma que la
+ * busqueda solo necesita la rejilla
+ */
+struct FPathQuery
+{
+	/**
+	 * Posicion en el Array1D de la casilla inicial
+	 */
+	int32 IndexIni;
+
+	/**
+	 * Posicion en el Array1D de la casilla de destino
+	 */
+	int32 IndexEnd;
+
+	/**
+	 * Faccion que se mueve
+	 */
+	int32 Faction;
+
+	/**
+	 * Si el elemento de la casilla de destino es enemigo
+	 */
+	bool IsGoalEnemy;
+
+	/**
+	 * Puntos de movimiento de la unidad al comienzo de cada turno
+	 */
+	int32 BaseMovementPoints;
+
+	/**
+	 * Puntos de movimiento actuales de la unidad
+	 */
+	int32 MovementPoints;
+
+	/**
+	 * Constructor por defecto. Establece los atributos a valores invalidos
+	 */
+	FPathQuery(): FPathQuery(-1, -1, -1, false, 0, 0)
+	{
+	}
+
+	/**
+	 * Constructor con parametros
+	 * 
+	 * @param Ini Posicion en el Array1D de la casilla inicial
+	 * @param End Posicion en el Array1D de la casilla de destino
+	 * @param F Faccion que se mueve
+	 * @param GoalEnemy Si el elemento de la casilla de destino es enemigo
+	 * @param BaseMP Puntos de movimiento de la unidad al comienzo de cada turno
+	 * @param MP Puntos de movimiento actuales de la unidad
+	 */
+	FPathQuery(const int32 Ini, const int32 End, const int32 F, const bool GoalEnemy, const int32 BaseMP,
+	           const int32 MP): IndexIni(Ini), IndexEnd(End), Faction(F), IsGoalEnemy(GoalEnemy),
+	                            BaseMovementPoints(BaseMP), MovementPoints(MP)
+	{
+	}
+
+	/**
+	 * Operador ==
+	 * 
+	 * @param Other Consulta con la que se compara
+	 * @return Si ambas consultas producen el mismo camino
+	 */
+	bool operator==(const FPathQuery& Other) const
+	{
+		return IndexIni == Other.IndexIni && IndexEnd == Other.IndexEnd && Faction == Other.Faction &&
+			IsGoalEnemy == Other.IsGoalEnemy && BaseMovementPoints == Other.BaseMovementPoints &&
+			MovementPoints == Other.MovementPoints;
+	}
+
+	/**
+	 * Funcion hash para poder emplear la consulta como clave de contenedores
+	 * 
+	 * @param Query Consulta de camino
+	 * @return Hash de la consulta
+	 */
+	friend uint32 GetTypeHash(const FPathQuery& Query)
+	{
+		uint32 Hash = HashCombine(GetTypeHash(Query.IndexIni), GetTypeHash(Query.IndexEnd));
+		Hash = HashCombine(Hash, GetTypeHash(Query.Faction * 2 + Query.IsGoalEnemy));
+		return HashCombine(Hash, GetTypeHash(Query.BaseMovementPoints * 256 + Query.MovementPoints));
+	}
+};
+
+/**
+ * Clase que agrupa las busquedas de caminos sobre la rejilla de casillas. Las busquedas solo leen la rejilla dada y
+ * escriben en el espacio de trabajo y el camino del llamante, sin llamar a ningun evento ni modificar el mapa, por lo
+ * que pueden ejecutarse en otros hilos siempre que cada hilo emplee su propio espacio de trabajo
+ */
+class FPathFinder
+{
+public:
+	/**
+	 * Metodo estatico que verifica si una unidad puede entrar en una casilla durante la busqueda de caminos. Si la
+	 * casilla contiene un elemento, solo se acepta si
+	 *		* es un asentamiento propio
+	 *		* se encuentra en la casilla de destino y es propiedad de una faccion enemiga (en guerra)
+	 * 
+	 * @param Grid Rejilla de casillas del mapa
+	 * @param Index Posicion en el Array1D de la casilla
+	 * @param IndexEnd Posicion en el Array1D de la casilla de destino
+	 * @param Faction Faccion que se mueve
+	 * @param IsGoalEnemy Si el elemento de la casilla de destino es enemigo
+	 * @return Si se puede entrar en la casilla
+	 */
+	static bool CanEnterTile(const FTileGrid& Grid, const int32 Index, const int32 IndexEnd, const int32 Faction,
+	                         const bool IsGoalEnemy)
+	{
+		if (!Grid.IsAccesible(Index)) return false;
+		if (!Grid.HasElement(Index)) return true;
+
+		const bool IsOwnSettlement = Faction != -1 && !Grid.HasUnit(Index) && Grid.SettlementOwners[Index] == Faction;
+		return IsOwnSettlement || (Index == IndexEnd && IsGoalEnemy);
+	}
+
+	/**
+	 * Metodo estatico que calcula el camino de una consulta, incluyendo el numero de turnos en alcanzar cada casilla
+	 * 
+	 * @param Grid Rejilla de casillas del mapa
+	 * @param Query Consulta de camino
+	 * @param Workspace Espacio de trabajo de la busqueda
+	 * @param OutPath Camino calculado, sin incluir la casilla inicial. Vacio si no existe camino
+	 * @param SearchMode Modo de la busqueda
+	 * @return Si se ha encontrado un camino
+	 */
+	static bool ComputePath(const FTileGrid& Grid, const FPathQuery& Query, FPathWorkspace& Workspace,
+	                        TArray<FMovement>& OutPath, const EPathSearchMode SearchMode = EPathSearchMode::Auto);
+
+	/**
+	 * Metodo estatico que calcula el camino de una consulta que necesita el menor numero de turnos. A diferencia del
+	 * resto de busquedas, el estado incluye los puntos de movimiento restantes, por lo que no se desperdician puntos de
+	 * movimiento al final de cada turno. A igual numero de turnos se minimiza el coste de movimiento.
+	 * 
+	 * La heuristica de turnos supone que cada casilla cuesta al menos un punto de movimiento, lo que la hace
+	 * consistente junto con la distancia entre casillas
+	 * 
+	 * @param Grid Rejilla de casillas del mapa
+	 * @param Query Consulta de camino
+	 * @param Workspace Espacio de trabajo de la busqueda por turnos
+	 * @param OutPath Camino calculado con el numero de turnos, sin incluir la casilla inicial
+	 * @return Si se ha encontrado un camino
+	 */
+	static bool ComputePathByTurns(const FTileGrid& Grid, const FPathQuery& Query, FTurnPathWorkspace& Workspace,
+	                               TArray<FMovement>& OutPath);
+
+	/**
+	 * Metodo estatico que calcula el turno en el que una unidad alcanza cada casilla con una unica busqueda (Dijkstra)
+	 * sobre los estados (casilla, puntos de movimiento restantes). Los turnos se cuentan igual que al seguir un camino:
+	 * si el coste de una casilla supera los puntos de movimiento restantes, se entra en ella en el siguiente turno.
+	 * 
+	 * Las casillas con elementos de otras facciones se consideran alcanzables, ya que pueden ser objetivo de un ataque,
+	 * pero la busqueda no continua a traves de ellas
+	 * 
+	 * @param Grid Rejilla de casillas del mapa
+	 * @param IndexIni Posicion en el Array1D de la casilla de la unidad
+	 * @param Faction Faccion que se mueve
+	 * @param BaseMovementPoints Puntos de movimiento de la unidad al comienzo de cada turno
+	 * @param MovementPoints Puntos de movimiento actuales de la unidad
+	 * @param MaxTurns Numero maximo de turnos que se calculan, como mucho Unreachable - 1
+	 * @param Workspace Espacio de trabajo de la busqueda por turnos
+	 * @param OutMap Mapa de turnos calculado
+	 */
+	static void ComputeReachability(const FTileGrid& Grid, const int32 IndexIni, const int32 Faction,
+	                                const int32 BaseMovementPoints, const int32 MovementPoints, const int32 MaxTurns,
+	                                FTurnPathWorkspace& Workspace, FReachabilityMap& OutMap);
+
+	/**
+	 * Metodo estatico que calcula el mejor camino entre dos casillas (A*).
+	 * 
+	 * En las regiones de coste uniforme existen muchos caminos optimos simetricos y A* expande todos ellos. Al romper
+	 * las simetrias no se generan los vecinos que tambien son vecinos de la casilla previa, ya que desde ella se
+	 * alcanzan con menor coste, y a igual prioridad se expande antes la casilla con mayor coste acumulado, de forma que
+	 * la busqueda avanza por un unico camino. Ambas tecnicas mantienen la optimalidad del camino
+	 * 
+	 * @param Grid Rejilla de casillas del mapa
+	 * @param IndexIni Posicion en el Array1D de la casilla inicial
+	 * @param IndexEnd Posicion en el Array1D de la casilla de destino
+	 * @param Faction Faccion que se mueve
+	 * @param IsGoalEnemy Si el elemento de la casilla de destino es enemigo
+	 * @param Workspace Espacio de trabajo de la busqueda
+	 * @param OutPath Camino calculado, sin incluir la casilla inicial y sin el numero de turnos
+	 * @param SearchMode Modo de la busqueda
+	 * @return Si se ha encontrado un camino
+	 */
+	static bool SearchPath(const FTileGrid& Grid, const int32 IndexIni, const int32 IndexEnd, const int32 Faction,
+	                       const bool IsGoalEnemy, FPathWorkspace& Workspace, TArray<FMovement>& OutPath,
+	                       const EPathSearchMode SearchMode = EPathSearchMode::Auto);
+
+	/**
+	 * Metodo estatico que verifica si una casilla y sus vecinos accesibles tienen el mismo coste de movimiento
+	 * 
+	 * @param Grid Rejilla de casillas del mapa
+	 * @param Index Posicion en el Array1D de la casilla
+	 * @return Si la region de la casilla tiene coste uniforme
+	 */
+	static bool IsUniformRegion(const FTileGrid& Grid, const int32 Index);
+
+	/**
+	 * Metodo estatico que calcula el mejor camino entre dos casillas con una busqueda A* bidireccional. Cada busqueda
+	 * emplea como heuristica la distancia a la casilla de origen de la otra y se alterna expandiendo la de menor
+	 * prioridad. Cada vez que una casilla se alcanza en ambas busquedas se actualiza el mejor camino encontrado, y la
+	 * busqueda termina cuando su coste no supera la mayor de las prioridades minimas de ambas colas, lo que garantiza
+	 * que es optimo con heuristicas consistentes
+	 * 
+	 * @param Grid Rejilla de casillas del mapa
+	 * @param IndexIni Posicion en el Array1D de la casilla inicial
+	 * @param IndexEnd Posicion en el Array1D de la casilla de destino
+	 * @param Faction Faccion que se mueve
+	 * @param IsGoalEnemy Si el elemento de la casilla de destino es enemigo
+	 * @param Workspace Espacio de trabajo de la busqueda, emplea tambien los datos de la busqueda inversa
+	 * @param OutPath Camino calculado, sin incluir la casilla inicial y sin el numero de turnos
+	 * @return Si se ha encontrado un camino
+	 */
+	static bool SearchPathBidirectional(const FTileGrid& Grid, const int32 IndexIni, const int32 IndexEnd,
+	                                    const int32 Faction, const bool IsGoalEnemy, FPathWorkspace& Workspace,
+	                                    TArray<FMovement>& OutPath);
+
+	/**
+	 * Metodo estatico que calcula el coste de llegar a una casilla de destino desde varias casillas iniciales con una
+	 * unica busqueda inversa (Dijkstra desde el destino). La procedencia almacenada en el espacio de trabajo de cada
+	 * casilla es la siguiente casilla del camino hacia el destino
+	 * 
+	 * @param Grid Rejilla de casillas del mapa
+	 * @param Starts Posiciones en el Array1D de las casillas iniciales
+	 * @param IndexEnd Posicion en el Array1D de la casilla de destino
+	 * @param Faction Faccion que se mueve
+	 * @param IsGoalEnemy Si el elemento de la casilla de destino es enemigo
+	 * @param Workspace Espacio de trabajo de la busqueda
+	 */
+	static void SearchPathsToGoal(const FTileGrid& Grid, const TArray<int32>& Starts, const int32 IndexEnd,
+	                              const int32 Faction, const bool IsGoalEnemy, FPathWorkspace& Workspace);
+
+	/**
+	 * Metodo estatico que calcula un campo de flujo hacia las casillas objetivo con una unica busqueda inversa
+	 * (Dijkstra desde todos los objetivos a la vez). Solo lee la rejilla, por lo que puede ejecutarse fuera del hilo
+	 * principal sobre una copia del mapa
+	 * 
+	 * @param Grid Rejilla de casillas del mapa
+	 * @param Targets Posiciones en el Array1D de las casillas objetivo
+	 * @param Faction Faccion que se mueve
+	 * @param TargetsAreEnemies Si los objetivos son elementos enemigos en los que se puede entrar aunque esten ocupados
+	 * @param OutField Campo de flujo calculado
+	 * @param TargetCosts Si se proporciona, coste inicial de cada objetivo en el mismo orden que Targets. Permite
+	 * preferir unos objetivos frente a otros aunque esten mas lejos
+	 */
+	static void BuildFlowField(const FTileGrid& Grid, const TArray<int32>& Targets, const int32 Faction,
+	                           const bool TargetsAreEnemies, FFlowField& OutField,
+	                           const TArray<int32>* TargetCosts = nullptr);
+};
@@ -0,0 +1,187 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FPathReplanner.h"
+
+void FPathReplanner::Init(const FTileGrid& Grid, const FPathQuery& Query, const uint32 NewMapVersion)
+{
+	const int32 NumTiles = Grid.Num();
+	G.Init(MAX_int32, NumTiles);
+	Rhs.Init(MAX_int32, NumTiles);
+	QueuedKeys.SetNumUninitialized(NumTiles);
+	InQueue.Init(false, NumTiles);
+	Queue.Reset();
+
+	IndexIni = Query.IndexIni;
+	IndexLast = Query.IndexIni;
+	IndexEnd = Query.IndexEnd;
+	Faction = Query.Faction;
+	IsGoalEnemy = Query.IsGoalEnemy;
+	KeyModifier = 0;
+	MapVersion = NewMapVersion;
+
+	// La busqueda comienza en el destino
+	Rhs[IndexEnd] = 0;
+	UpdateVertex(Grid, IndexEnd);
+}
+
+void FPathReplanner::Reset()
+{
+	G.Empty();
+	Rhs.Empty();
+	QueuedKeys.Empty();
+	InQueue.Empty();
+	Queue.Empty();
+
+	IndexIni = IndexLast = IndexEnd = -1;
+}
+
+bool FPathReplanner::CanRepair(const FTileGrid& Grid, const FPathQuery& Query) const
+{
+	return G.Num() == Grid.Num() && IndexEnd == Query.IndexEnd && Faction == Query.Faction &&
+		IsGoalEnemy == Query.IsGoalEnemy;
+}
+
+void FPathReplanner::NotifyTileChanged(const FTileGrid& Grid, const int32 Index)
+{
+	if (!G.IsValidIndex(Index)) return;
+
+	// Solo cambia el coste de entrar en la casilla, por lo que se recalculan sus vecinos
+	Grid.ForEachNeighbor(Index, [&](const int32 Neighbor) { UpdateVertex(Grid, Neighbor); });
+}
+
+bool FPathReplanner::Replan(const FTileGrid& Grid, const int32 NewIndexIni, const uint32 NewMapVersion,
+                            TArray<FMovement>& OutPath)
+{
+	OutPath.Reset();
+	if (!G.IsValidIndex(NewIndexIni)) return false;
+
+	// Se acumula la heuristica recorrida por la unidad desde la ultima reparacion para mantener validas las claves
+	// de la cola sin reordenarla
+	IndexIni = NewIndexIni;
+	KeyModifier += ULibraryTileMap::GetDistanceToElement(Grid.GetPos(IndexLast), Grid.GetPos(IndexIni));
+	IndexLast = IndexIni;
+	MapVersion = NewMapVersion;
+
+	ComputeShortestPath(Grid);
+	if (G[IndexIni] == MAX_int32) return false;
+
+	// Se obtiene el camino eligiendo en cada casilla el vecino con menor coste hasta el destino
+	int32 TotalCost = 0;
+	for (int32 Current = IndexIni; Current != IndexEnd;)
+	{
+		int32 Best = -1;
+		int32 BestCost = MAX_int32;
+		Grid.ForEachNeighbor(Current, [&](const int32 Index)
+		{
+			const int32 EnterCost = GetEnterCost(Grid, Index);
+			if (EnterCost == MAX_int32 || G[Index] == MAX_int32) return;
+
+			if (EnterCost + G[Index] < BestCost)
+			{
+				Best = Index;
+				BestCost = EnterCost + G[Index];
+			}
+		});
+
+		// Si no se puede avanzar o el camino contiene un ciclo, la busqueda es inconsistente
+		if (Best == -1 || OutPath.Num() >= Grid.Num())
+		{
+			OutPath.Reset();
+			return false;
+		}
+
+		TotalCost += Grid.Costs[Best];
+		OutPath.Add(FMovement(Grid.GetPos(Best), Grid.Costs[Best], TotalCost));
+		Current = Best;
+	}
+
+	return true;
+}
+
+FReplannerKey FPathReplanner::CalculateKey(const FTileGrid& Grid, const int32 Index) const
+{
+	const int32 MinCost = FMath::Min(G[Index], Rhs[Index]);
+	if (MinCost == MAX_int32) return FReplannerKey{MAX_int32, MAX_int32};
+
+	const int32 Heuristic = ULibraryTileMap::GetDistanceToElement(Grid.GetPos(IndexIni), Grid.GetPos(Index));
+	return FReplannerKey{MinCost + Heuristic + KeyModifier, MinCost};
+}
+
+void FPathReplanner::UpdateVertex(const FTileGrid& Grid, const int32 Index)
+{
+	// El valor anticipado es el menor coste de entrar en un vecino y llegar desde el al destino
+	if (Index != IndexEnd)
+	{
+		int32 NewRhs = MAX_int32;
+		if (Grid.IsAccesible(Index))
+		{
+			Grid.ForEachNeighbor(Index, [&](const int32 Neighbor)
+			{
+				const int32 EnterCost = GetEnterCost(Grid, Neighbor);
+				if (EnterCost != MAX_int32 && G[Neighbor] != MAX_int32)
+				{
+					NewRhs = FMath::Min(NewRhs, EnterCost + G[Neighbor]);
+				}
+			});
+		}
+
+		Rhs[Index] = NewRhs;
+	}
+
+	// Si la casilla es inconsistente se inserta en la cola con su nueva clave, la entrada previa queda obsoleta
+	if (G[Index] != Rhs[Index])
+	{
+		QueuedKeys[Index] = CalculateKey(Grid, Index);
+		InQueue[Index] = true;
+		Queue.HeapPush(FReplannerNode{Index, QueuedKeys[Index]});
+	}
+	else
+	{
+		InQueue[Index] = false;
+	}
+}
+
+void FPathReplanner::ComputeShortestPath(const FTileGrid& Grid)
+{
+	while (true)
+	{
+		// Se descartan las entradas obsoletas de la cola
+		while (Queue.Num() > 0 && !(InQueue[Queue.HeapTop().Index] &&
+			QueuedKeys[Queue.HeapTop().Index] == Queue.HeapTop().Key))
+		{
+			Queue.HeapPopDiscard(false);
+		}
+
+		// Se finaliza cuando la casilla actual de la unidad es consistente y no quedan nodos que puedan mejorarla
+		if (Queue.Num() == 0) break;
+		if (!(Queue.HeapTop().Key < CalculateKey(Grid, IndexIni)) && G[IndexIni] == Rhs[IndexIni]) break;
+
+		FReplannerNode Node;
+		Queue.HeapPop(Node, false);
+		const int32 Index = Node.Index;
+		InQueue[Index] = false;
+
+		// Si la clave ha aumentado desde que se inserto, se vuelve a insertar con la clave actual
+		const FReplannerKey NewKey = CalculateKey(Grid, Index);
+		if (Node.Key < NewKey)
+		{
+			QueuedKeys[Index] = NewKey;
+			InQueue[Index] = true;
+			Queue.HeapPush(FReplannerNode{Index, NewKey});
+		}
+		else if (G[Index] > Rhs[Index])
+		{
+			// La casilla estaba sobreestimada, se fija su coste y se propaga a los vecinos
+			G[Index] = Rhs[Index];
+			Grid.ForEachNeighbor(Index, [&](const int32 Neighbor) { UpdateVertex(Grid, Neighbor); });
+		}
+		else
+		{
+			// La casilla estaba subestimada, se invalida y se recalculan ella y sus vecinos
+			G[Index] = MAX_int32;
+			UpdateVertex(Grid, Index);
+			Grid.ForEachNeighbor(Index, [&](const int32 Neighbor) { UpdateVertex(Grid, Neighbor); });
+		}
+	}
+}
@@ -0,0 +1,188 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FMovement.h"
+#include "FPathFinder.h"
+#include "FTileGrid.h"
+
+/**
+ * Estructura que almacena la clave de un nodo de la busqueda incremental. Las claves se comparan de forma
+ * lexicografica
+ */
+struct FReplannerKey
+{
+	/**
+	 * Coste estimado del camino que pasa por el nodo
+	 */
+	int32 K1;
+
+	/**
+	 * Coste de llegar desde el nodo al destino
+	 */
+	int32 K2;
+
+	bool operator<(const FReplannerKey& Other) const { return K1 < Other.K1 || (K1 == Other.K1 && K2 < Other.K2); }
+	bool operator==(const FReplannerKey& Other) const { return K1 == Other.K1 && K2 == Other.K2; }
+};
+
+/**
+ * Estructura que almacena un nodo de la cola de la busqueda incremental junto con su clave
+ */
+struct FReplannerNode
+{
+	/**
+	 * Posicion en el Array1D de la casilla
+	 */
+	int32 Index;
+
+	/**
+	 * Clave del nodo en el momento de insertarlo en la cola
+	 */
+	FReplannerKey Key;
+
+	bool operator<(const FReplannerNode& Other) const { return Key < Other.Key; }
+};
+
+/**
+ * Clase que implementa la reparacion incremental de caminos (D* Lite). La busqueda se realiza desde el destino hacia
+ * la unidad y conserva el coste de cada casilla entre llamadas, de forma que cuando cambia el coste de algunas
+ * casillas o la unidad avanza por el camino solo se recalculan los nodos afectados en lugar de todo el camino.
+ * 
+ * Cada unidad que sigue un camino mantiene su propio replanificador. Los arrays son densos y se liberan al
+ * eliminar el camino
+ */
+class FPathReplanner
+{
+public:
+	/**
+	 * Metodo que inicializa la busqueda para una consulta de camino
+	 * 
+	 * @param Grid Rejilla de casillas del mapa
+	 * @param Query Consulta de camino
+	 * @param MapVersion Version del mapa sobre la que se inicializa la busqueda
+	 */
+	void Init(const FTileGrid& Grid, const FPathQuery& Query, const uint32 MapVersion);
+
+	/**
+	 * Metodo que libera los datos de la busqueda
+	 */
+	void Reset();
+
+	/**
+	 * Metodo que verifica si la busqueda almacenada puede repararse para la consulta dada. Solo puede repararse si el
+	 * destino, la faccion y el tamano del mapa no han cambiado
+	 * 
+	 * @param Grid Rejilla de casillas del mapa
+	 * @param Query Consulta de camino
+	 * @return Si la busqueda puede repararse
+	 */
+	bool CanRepair(const FTileGrid& Grid, const FPathQuery& Query) const;
+
+	/**
+	 * Getter de la version del mapa sobre la que se ha calculado la busqueda
+	 * 
+	 * @return Version del mapa
+	 */
+	uint32 GetMapVersion() const { return MapVersion; }
+
+	/**
+	 * Metodo que notifica que una casilla ha cambiado desde la ultima reparacion
+	 * 
+	 * @param Grid Rejilla de casillas del mapa
+	 * @param Index Posicion en el Array1D de la casilla modificada
+	 */
+	void NotifyTileChanged(const FTileGrid& Grid, const int32 Index);
+
+	/**
+	 * Metodo que repara la busqueda desde la posicion actual de la unidad y obtiene el camino resultante
+	 * 
+	 * @param Grid Rejilla de casillas del mapa
+	 * @param IndexIni Posicion en el Array1D de la casilla actual de la unidad
+	 * @param NewMapVersion Version actual del mapa
+	 * @param OutPath Camino calculado, sin incluir la casilla inicial y sin el numero de turnos
+	 * @return Si se ha encontrado un camino
+	 */
+	bool Replan(const FTileGrid& Grid, const int32 IndexIni, const uint32 NewMapVersion, TArray<FMovement>& OutPath);
+
+private:
+	/**
+	 * Coste de llegar desde cada casilla hasta el destino (g) y valor anticipado a partir de sus vecinos (rhs)
+	 */
+	TArray<int32> G;
+	TArray<int32> Rhs;
+
+	/**
+	 * Clave con la que se encuentra cada casilla en la cola y si se encuentra en ella. Las entradas de la cola que no
+	 * coinciden se descartan al extraerlas (eliminacion perezosa)
+	 */
+	TArray<FReplannerKey> QueuedKeys;
+	TBitArray<> InQueue;
+
+	/**
+	 * Cola con prioridad de la busqueda, almacenada como un monticulo
+	 */
+	TArray<FReplannerNode> Queue;
+
+	/**
+	 * Casilla actual de la unidad, casilla de la unidad en la ultima reparacion y casilla de destino
+	 */
+	int32 IndexIni = -1;
+	int32 IndexLast = -1;
+	int32 IndexEnd = -1;
+
+	/**
+	 * Faccion que se mueve y si el elemento de la casilla de destino es enemigo
+	 */
+	int32 Faction = -1;
+	bool IsGoalEnemy = false;
+
+	/**
+	 * Acumulado de la heuristica a medida que la unidad avanza, evita reordenar la cola (km)
+	 */
+	int32 KeyModifier = 0;
+
+	/**
+	 * Version del mapa sobre la que se ha calculado la busqueda
+	 */
+	uint32 MapVersion = 0;
+
+	//----------------------------------------------------------------------------------------------------------------//
+
+	/**
+	 * Metodo privado que obtiene el coste de entrar en una casilla
+	 * 
+	 * @param Grid Rejilla de casillas del mapa
+	 * @param Index Posicion en el Array1D de la casilla
+	 * @return Coste de entrar en la casilla o MAX_int32 si no se puede entrar
+	 */
+	int32 GetEnterCost(const FTileGrid& Grid, const int32 Index) const
+	{
+		return FPathFinder::CanEnterTile(Grid, Index, IndexEnd, Faction, IsGoalEnemy) ? Grid.Costs[Index] : MAX_int32;
+	}
+
+	/**
+	 * Metodo privado que calcula la clave de una casilla
+	 * 
+	 * @param Grid Rejilla de casillas del mapa
+	 * @param Index Posicion en el Array1D de la casilla
+	 * @return Clave de la casilla
+	 */
+	FReplannerKey CalculateKey(const FTileGrid& Grid, const int32 Index) const;
+
+	/**
+	 * Metodo privado que recalcula el valor anticipado de una casilla y la inserta en la cola si es inconsistente
+	 * 
+	 * @param Grid Rejilla de casillas del mapa
+	 * @param Index Posicion en el Array1D de la casilla
+	 */
+	void UpdateVertex(const FTileGrid& Grid, const int32 Index);
+
+	/**
+	 * Metodo privado que procesa la cola hasta que el coste de la casilla actual de la unidad es consistente
+	 * 
+	 * @param Grid Rejilla de casillas del mapa
+	 */
+	void ComputeShortestPath(const FTileGrid& Grid);
+};
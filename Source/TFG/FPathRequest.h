@@ -0,0 +1,60 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FUnitInfo.h"
+
+/**
+ * Estructura que almacena los datos de una peticion de calculo de camino. Se emplea para calcular los caminos de
+ * varias unidades a la vez sin pasar por los eventos de la interfaz
+ */
+struct FPathRequest
+{
+	/**
+	 * Posicion inicial de la unidad
+	 */
+	FIntPoint PosIni;
+
+	/**
+	 * Posicion de destino de la unidad
+	 */
+	FIntPoint PosEnd;
+
+	/**
+	 * Tipo de unidad que se mueve
+	 */
+	EUnitType UnitType;
+
+	/**
+	 * Puntos de movimiento de la unidad al comienzo de cada turno
+	 */
+	int32 BaseMovementPoints;
+
+	/**
+	 * Puntos de movimiento actuales de la unidad
+	 */
+	int32 MovementPoints;
+
+	/**
+	 * Constructor por defecto. Establece los atributos a valores invalidos
+	 */
+	FPathRequest(): FPathRequest(FIntPoint(-1), FIntPoint(-1), EUnitType::None, 0, 0)
+	{
+	}
+
+	/**
+	 * Constructor con parametros
+	 * 
+	 * @param Ini Posicion inicial de la unidad
+	 * @param End Posicion de destino de la unidad
+	 * @param Type Tipo de unidad que se mueve
+	 * @param BaseMP Puntos de movimiento de la unidad al comienzo de cada turno
+	 * @param MP Puntos de movimiento actuales de la unidad
+	 */
+	FPathRequest(const FIntPoint& Ini, const FIntPoint& End, const EUnitType Type, const int32 BaseMP,
+	             const int32 MP): PosIni(Ini), PosEnd(End), UnitType(Type), BaseMovementPoints(BaseMP),
+	                              MovementPoints(MP)
+	{
+	}
+};
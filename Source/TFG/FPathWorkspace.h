@@ -0,0 +1,182 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Estructura que almacena los datos temporales de una busqueda de caminos sobre el mapa. Los datos se almacenan en
+ * arrays densos indexados por la posicion de la casilla en el Array1D y se reutilizan entre busquedas.
+ * 
+ * Para evitar limpiar los arrays en cada busqueda se emplea un contador de generacion: una casilla solo tiene datos
+ * validos si su marca coincide con la generacion de la busqueda actual
+ */
+struct FPathWorkspace
+{
+	/**
+	 * Coste acumulado de llegar a cada casilla
+	 */
+	TArray<int32> Cost;
+
+	/**
+	 * Indice de la casilla desde la que se ha llegado a cada casilla
+	 */
+	TArray<int32> Parent;
+
+	/**
+	 * Generacion en la que se ha visitado cada casilla por ultima vez
+	 */
+	TArray<uint32> Visited;
+
+	/**
+	 * Datos de la busqueda inversa (desde el destino) de la busqueda bidireccional: coste de llegar desde cada casilla
+	 * al destino, siguiente casilla hacia el destino y generacion en la que se ha visitado. Solo se reservan si se
+	 * realiza una busqueda bidireccional
+	 */
+	TArray<int32> ReverseCost;
+	TArray<int32> ReverseParent;
+	TArray<uint32> ReverseVisited;
+
+	/**
+	 * Generacion de la busqueda actual
+	 */
+	uint32 Generation = 0;
+
+	/**
+	 * Numero de casillas expandidas en la busqueda actual. Permite comparar el rendimiento de los modos de busqueda
+	 */
+	int32 NumExpanded = 0;
+
+	/**
+	 * Metodo que prepara los arrays para el numero de casillas dado. Solo se reserva memoria si el tamano cambia
+	 * 
+	 * @param NumTiles Numero de casillas del mapa
+	 */
+	void Init(const int32 NumTiles)
+	{
+		if (Visited.Num() == NumTiles) return;
+
+		Cost.SetNumUninitialized(NumTiles);
+		Parent.SetNumUninitialized(NumTiles);
+		Visited.SetNumZeroed(NumTiles);
+
+		// Los datos de la busqueda inversa se invalidan y se reservan de nuevo cuando se necesiten
+		ReverseCost.Empty();
+		ReverseParent.Empty();
+		ReverseVisited.Empty();
+
+		Generation = 0;
+	}
+
+	/**
+	 * Metodo que prepara los arrays de la busqueda inversa. Debe llamarse despues de Init
+	 */
+	void InitReverse()
+	{
+		if (ReverseVisited.Num() == Visited.Num()) return;
+
+		ReverseCost.SetNumUninitialized(Visited.Num());
+		ReverseParent.SetNumUninitialized(Visited.Num());
+		ReverseVisited.SetNumZeroed(Visited.Num());
+	}
+
+	/**
+	 * Metodo que comienza una nueva busqueda invalidando todos los datos previos en O(1)
+	 */
+	void NewSearch()
+	{
+		NumExpanded = 0;
+
+		// Si el contador se desborda, se limpian las marcas para que ninguna coincida con la nueva generacion
+		if (++Generation == 0)
+		{
+			FMemory::Memzero(Visited.GetData(), Visited.Num() * sizeof(uint32));
+			FMemory::Memzero(ReverseVisited.GetData(), ReverseVisited.Num() * sizeof(uint32));
+			Generation = 1;
+		}
+	}
+
+	/**
+	 * Metodo que verifica si la casilla dada se ha alcanzado en la busqueda actual
+	 * 
+	 * @param Index Posicion en el Array1D
+	 * @return Si la casilla tiene datos validos
+	 */
+	bool IsVisited(const int32 Index) const { return Visited[Index] == Generation; }
+
+	/**
+	 * Metodo que devuelve el coste de llegar a la casilla dada
+	 * 
+	 * @param Index Posicion en el Array1D
+	 * @return Coste de llegar a la casilla o MAX_int32 si no se ha alcanzado
+	 */
+	int32 GetCost(const int32 Index) const { return IsVisited(Index) ? Cost[Index] : MAX_int32; }
+
+	/**
+	 * Metodo que actualiza los datos de la casilla dada en la busqueda actual
+	 * 
+	 * @param Index Posicion en el Array1D
+	 * @param NodeCost Coste de llegar a la casilla
+	 * @param NodeParent Posicion en el Array1D de la casilla desde la que se llega
+	 */
+	void SetNode(const int32 Index, const int32 NodeCost, const int32 NodeParent)
+	{
+		Cost[Index] = NodeCost;
+		Parent[Index] = NodeParent;
+		Visited[Index] = Generation;
+	}
+
+	/**
+	 * Metodo que verifica si la casilla dada se ha alcanzado en la busqueda inversa actual
+	 * 
+	 * @param Index Posicion en el Array1D
+	 * @return Si la casilla tiene datos validos en la busqueda inversa
+	 */
+	bool IsReverseVisited(const int32 Index) const { return ReverseVisited[Index] == Generation; }
+
+	/**
+	 * Metodo que devuelve el coste de llegar desde la casilla dada hasta el destino en la busqueda inversa
+	 * 
+	 * @param Index Posicion en el Array1D
+	 * @return Coste de llegar al destino o MAX_int32 si no se ha alcanzado
+	 */
+	int32 GetReverseCost(const int32 Index) const { return IsReverseVisited(Index) ? ReverseCost[Index] : MAX_int32; }
+
+	/**
+	 * Metodo que actualiza los datos de la casilla dada en la busqueda inversa actual
+	 * 
+	 * @param Index Posicion en el Array1D
+	 * @param NodeCost Coste de llegar desde la casilla al destino
+	 * @param NodeParent Posicion en el Array1D de la siguiente casilla hacia el destino
+	 */
+	void SetReverseNode(const int32 Index, const int32 NodeCost, const int32 NodeParent)
+	{
+		ReverseCost[Index] = NodeCost;
+		ReverseParent[Index] = NodeParent;
+		ReverseVisited[Index] = Generation;
+	}
+};
+
+/**
+ * Estructura que almacena los datos temporales de la busqueda de caminos por turnos. Cada estado es una pareja
+ * (casilla, puntos de movimiento restantes) y se almacena en la posicion Casilla * (BaseMovementPoints + 1) + Puntos,
+ * de forma que los estados de una misma casilla son contiguos. Los arrays heredados se indexan por estado
+ */
+struct FTurnPathWorkspace : FPathWorkspace
+{
+	/**
+	 * Turno en el que se alcanza cada estado
+	 */
+	TArray<int32> Turns;
+
+	/**
+	 * Metodo que prepara los arrays para el numero de estados dado
+	 * 
+	 * @param NumStates Numero de estados de la busqueda
+	 */
+	void InitStates(const int32 NumStates)
+	{
+		Init(NumStates);
+		Turns.SetNumUninitialized(NumStates, false);
+	}
+};
@@ -0,0 +1,106 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Estructura que almacena el numero de turnos que necesita una unidad para alcanzar cada casilla del mapa. Se calcula
+ * con una unica busqueda (Dijkstra) sobre los estados (casilla, puntos de movimiento restantes), por lo que el numero
+ * de turnos coincide con el que se obtiene al seguir el camino calculado.
+ * 
+ * El mapa se conserva mientras la unidad no cambie de posicion o de puntos de movimiento y la version del mapa no
+ * cambie
+ */
+struct FReachabilityMap
+{
+	/**
+	 * Valor de las casillas que no se pueden alcanzar en el numero maximo de turnos
+	 */
+	static constexpr uint8 Unreachable = MAX_uint8;
+
+	/**
+	 * Turno en el que se alcanza cada casilla indexado por la posicion en el Array1D. La casilla de la unidad tiene
+	 * el valor 0 y las casillas alcanzables en el turno actual el valor 1
+	 */
+	TArray<uint8> Turns;
+
+	/**
+	 * Posicion en el Array1D de la casilla de la unidad
+	 */
+	int32 IndexIni = -1;
+
+	/**
+	 * Faccion para la que se ha calculado el mapa
+	 */
+	int32 Faction = -1;
+
+	/**
+	 * Puntos de movimiento de la unidad al comienzo de cada turno
+	 */
+	int32 BaseMovementPoints = 0;
+
+	/**
+	 * Puntos de movimiento de la unidad al calcular el mapa
+	 */
+	int32 MovementPoints = 0;
+
+	/**
+	 * Numero maximo de turnos calculados
+	 */
+	int32 MaxTurns = 0;
+
+	/**
+	 * Version del mapa sobre la que se ha calculado
+	 */
+	uint32 MapVersion = MAX_uint32;
+
+	/**
+	 * Metodo que verifica si el mapa calculado sigue siendo valido para los datos dados
+	 * 
+	 * @param Index Posicion en el Array1D de la casilla de la unidad
+	 * @param F Faccion que se mueve
+	 * @param BaseMP Puntos de movimiento de la unidad al comienzo de cada turno
+	 * @param MP Puntos de movimiento actuales de la unidad
+	 * @param NumTurns Numero de turnos necesarios
+	 * @param Version Version actual del mapa
+	 * @return Si se puede emplear el mapa sin recalcularlo
+	 */
+	bool IsValidFor(const int32 Index, const int32 F, const int32 BaseMP, const int32 MP, const int32 NumTurns,
+	                const uint32 Version) const
+	{
+		return IndexIni != -1 && IndexIni == Index && Faction == F && BaseMovementPoints == BaseMP &&
+			MovementPoints == MP && MaxTurns >= NumTurns && MapVersion == Version;
+	}
+
+	/**
+	 * Metodo que invalida el mapa para que se recalcule en la siguiente consulta
+	 */
+	void Reset()
+	{
+		Turns.Reset();
+		IndexIni = -1;
+		MapVersion = MAX_uint32;
+	}
+
+	/**
+	 * Metodo que devuelve el turno en el que se alcanza una casilla
+	 * 
+	 * @param Index Posicion en el Array1D
+	 * @return Turno en el que se alcanza la casilla o Unreachable si no se alcanza
+	 */
+	uint8 GetTurns(const int32 Index) const { return Turns.IsValidIndex(Index) ? Turns[Index] : Unreachable; }
+
+	/**
+	 * Metodo que verifica si una casilla distinta de la de la unidad se alcanza en el numero de turnos dado o menos
+	 * 
+	 * @param Index Posicion en el Array1D
+	 * @param NumTurns Numero de turnos
+	 * @return Si la casilla es alcanzable
+	 */
+	bool IsReachable(const int32 Index, const int32 NumTurns = 1) const
+	{
+		const uint8 TileTurns = GetTurns(Index);
+		return TileTurns != 0 && TileTurns != Unreachable && TileTurns <= NumTurns;
+	}
+};
@@ -0,0 +1,95 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FSettlementDistanceField.h"
+
+#include "LibraryTileMap.h"
+
+void FSettlementDistanceField::Init(const FTileGrid& Grid)
+{
+	Distances.Init(MAX_int32, Grid.Num());
+	Closest.Init(-1, Grid.Num());
+	Settlements.Reset();
+}
+
+void FSettlementDistanceField::AddSettlement(const FTileGrid& Grid, const int32 Settlement, TArray<int32>* OutChanged)
+{
+	if (!Grid.IsValidIndex(Settlement) || Settlements.Contains(Settlement)) return;
+	if (!IsInitialized(Grid)) Init(Grid);
+
+	Settlements.Add(Settlement);
+	const FIntPoint SettlementPos = Grid.GetPos(Settlement);
+
+	// Se propaga el asentamiento por los vecinos mientras sea mas cercano que el actual de cada casilla
+	TArray<int32> Stack;
+	Distances[Settlement] = 0;
+	Closest[Settlement] = Settlement;
+	Stack.Add(Settlement);
+
+	while (Stack.Num() > 0)
+	{
+		const int32 Current = Stack.Pop(false);
+		if (OutChanged) OutChanged->Add(Current);
+
+		Grid.ForEachNeighbor(Current, [&](const int32 Index)
+		{
+			const int32 Distance = ULibraryTileMap::GetDistanceToElement(SettlementPos, Grid.GetPos(Index));
+			if (!IsCloser(Index, Distance, Settlement)) return;
+
+			Distances[Index] = Distance;
+			Closest[Index] = Settlement;
+			Stack.Add(Index);
+		});
+	}
+}
+
+void FSettlementDistanceField::RemoveSettlement(const FTileGrid& Grid, const int32 Settlement,
+                                                TArray<int32>* OutChanged)
+{
+	if (Settlements.Remove(Settlement) == 0) return;
+
+	// Se obtienen las casillas de la region del asentamiento y se dejan sin asentamiento mas cercano
+	TArray<int32> Region;
+	Region.Add(Settlement);
+	Distances[Settlement] = MAX_int32;
+	Closest[Settlement] = -1;
+
+	for (int32 i = 0; i < Region.Num(); ++i)
+	{
+		Grid.ForEachNeighbor(Region[i], [&](const int32 Index)
+		{
+			if (Closest[Index] != Settlement) return;
+
+			Distances[Index] = MAX_int32;
+			Closest[Index] = -1;
+			Region.Add(Index);
+		});
+	}
+
+	// El nuevo asentamiento mas cercano de cada casilla de la region es el de alguna de las regiones vecinas, ya que
+	// las casillas de fuera de la region no cambian
+	TArray<int32, TInlineAllocator<8>> Candidates;
+	for (const int32 Tile : Region)
+	{
+		Grid.ForEachNeighbor(Tile, [&](const int32 Index)
+		{
+			if (Closest[Index] != -1) Candidates.AddUnique(Closest[Index]);
+		});
+	}
+
+	for (const int32 Tile : Region)
+	{
+		const FIntPoint Pos = Grid.GetPos(Tile);
+		for (const int32 Candidate : Candidates)
+		{
+			const int32 Distance = ULibraryTileMap::GetDistanceToElement(Pos, Grid.GetPos(Candidate));
+			if (IsCloser(Tile, Distance, Candidate))
+			{
+				Distances[Tile] = Distance;
+				Closest[Tile] = Candidate;
+			}
+		}
+	}
+
+	if (OutChanged) OutChanged->Append(Region);
+}
@@ -0,0 +1,104 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FTileGrid.h"
+
+/**
+ * Clase que almacena, para cada casilla, la distancia en casillas al asentamiento mas cercano de un conjunto y cual es
+ * ese asentamiento. A igual distancia se elige el asentamiento con menor posicion en el Array1D, de forma que la
+ * region de cada asentamiento (las casillas para las que es el mas cercano) es conexa.
+ * 
+ * Los datos se actualizan de forma incremental: al anadir un asentamiento solo se recorre su nueva region y al
+ * eliminarlo solo se recalculan las casillas de la suya a partir de los asentamientos de las regiones vecinas. Las
+ * consultas son lecturas de arrays en O(1)
+ */
+class FSettlementDistanceField
+{
+public:
+	/**
+	 * Metodo que inicializa el campo para la rejilla dada sin ningun asentamiento
+	 * 
+	 * @param Grid Rejilla de casillas del mapa
+	 */
+	void Init(const FTileGrid& Grid);
+
+	/**
+	 * Metodo que verifica si el campo se ha inicializado para la rejilla dada
+	 * 
+	 * @param Grid Rejilla de casillas del mapa
+	 * @return Si el campo tiene el tamano de la rejilla
+	 */
+	bool IsInitialized(const FTileGrid& Grid) const { return Distances.Num() == Grid.Num(); }
+
+	/**
+	 * Metodo que anade un asentamiento y actualiza las casillas para las que pasa a ser el mas cercano
+	 * 
+	 * @param Grid Rejilla de casillas del mapa
+	 * @param Settlement Posicion en el Array1D del asentamiento
+	 * @param OutChanged Si se proporciona, se anaden las casillas modificadas
+	 */
+	void AddSettlement(const FTileGrid& Grid, const int32 Settlement, TArray<int32>* OutChanged = nullptr);
+
+	/**
+	 * Metodo que elimina un asentamiento y recalcula el asentamiento mas cercano de las casillas para las que lo era
+	 * 
+	 * @param Grid Rejilla de casillas del mapa
+	 * @param Settlement Posicion en el Array1D del asentamiento
+	 * @param OutChanged Si se proporciona, se anaden las casillas modificadas
+	 */
+	void RemoveSettlement(const FTileGrid& Grid, const int32 Settlement, TArray<int32>* OutChanged = nullptr);
+
+	/**
+	 * Getter del atributo Settlements
+	 * 
+	 * @return Posiciones en el Array1D de los asentamientos
+	 */
+	const TArray<int32>& GetSettlements() const { return Settlements; }
+
+	/**
+	 * Metodo que devuelve la distancia de una casilla al asentamiento mas cercano
+	 * 
+	 * @param Index Posicion en el Array1D
+	 * @return Distancia en casillas o MAX_int32 si no hay ningun asentamiento
+	 */
+	int32 GetDistance(const int32 Index) const { return Distances.IsValidIndex(Index) ? Distances[Index] : MAX_int32; }
+
+	/**
+	 * Metodo que devuelve el asentamiento mas cercano a una casilla
+	 * 
+	 * @param Index Posicion en el Array1D
+	 * @return Posicion en el Array1D del asentamiento o -1 si no hay ninguno
+	 */
+	int32 GetClosest(const int32 Index) const { return Closest.IsValidIndex(Index) ? Closest[Index] : -1; }
+
+private:
+	/**
+	 * Distancia de cada casilla al asentamiento mas cercano
+	 */
+	TArray<int32> Distances;
+
+	/**
+	 * Asentamiento mas cercano a cada casilla
+	 */
+	TArray<int32> Closest;
+
+	/**
+	 * Posiciones en el Array1D de los asentamientos
+	 */
+	TArray<int32> Settlements;
+
+	/**
+	 * Metodo privado que verifica si un asentamiento a la distancia dada es mas cercano que el actual de la casilla
+	 * 
+	 * @param Index Posicion en el Array1D de la casilla
+	 * @param Distance Distancia al asentamiento
+	 * @param Settlement Posicion en el Array1D del asentamiento
+	 * @return Si el asentamiento es mas cercano
+	 */
+	bool IsCloser(const int32 Index, const int32 Distance, const int32 Settlement) const
+	{
+		return Distance < Distances[Index] || (Distance == Distances[Index] && Settlement < Closest[Index]);
+	}
+};
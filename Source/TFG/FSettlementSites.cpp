@@ -0,0 +1,168 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FSettlementSites.h"
+
+#include "LibraryTileMap.h"
+
+void FSettlementSites::Init(const FTileGrid& Grid, const TArray<int32>& Owned, const TArray<FIntPoint>& Planned)
+{
+	const int32 NumTiles = Grid.Num();
+	Scores.Init(-1.0, NumTiles);
+	TileStates.SetNumUninitialized(NumTiles);
+	for (int32 Index = 0; Index < NumTiles; ++Index) TileStates[Index] = GetTileState(Grid, Index);
+
+	DirtyTiles.Reset();
+	IsDirty.Init(false, NumTiles);
+	Sites.Empty();
+
+	// Se propagan los asentamientos propios para obtener el mas cercano a cada casilla
+	OwnedField.Init(Grid);
+	for (const int32 Settlement : Owned) OwnedField.AddSettlement(Grid, Settlement);
+
+	// Se calculan los valores de todas las casillas
+	for (int32 Index = 0; Index < NumTiles; ++Index) MarkDirty(Index);
+	Update(Grid, Planned);
+}
+
+void FSettlementSites::NotifyTileChanged(const FTileGrid& Grid, const int32 Index)
+{
+	if (!Grid.IsValidIndex(Index)) return;
+
+	// Si no ha cambiado ningun dato del que dependen los valores, se descarta el cambio
+	const uint8 TileState = GetTileState(Grid, Index);
+	if (TileStates[Index] == TileState) return;
+
+	TileStates[Index] = TileState;
+	MarkDirtyAround(Grid, Index, SettlementMinDistance);
+}
+
+void FSettlementSites::NotifyPlannedChanged(const FTileGrid& Grid, const int32 Index)
+{
+	if (Grid.IsValidIndex(Index)) MarkDirtyAround(Grid, Index, SettlementMinDistance);
+}
+
+void FSettlementSites::SetOwnedSettlements(const FTileGrid& Grid, const TArray<int32>& Owned)
+{
+	// Se eliminan los asentamientos que ya no se poseen y se anaden los nuevos
+	TArray<int32> Changed;
+	const TArray<int32> Previous = OwnedField.GetSettlements();
+	for (const int32 Settlement : Previous)
+	{
+		if (!Owned.Contains(Settlement)) OwnedField.RemoveSettlement(Grid, Settlement, &Changed);
+	}
+
+	for (const int32 Settlement : Owned)
+	{
+		if (!Previous.Contains(Settlement)) OwnedField.AddSettlement(Grid, Settlement, &Changed);
+	}
+
+	// Se recalculan las casillas cuyo asentamiento mas cercano ha cambiado
+	for (const int32 Index : Changed) MarkDirty(Index);
+}
+
+void FSettlementSites::Update(const FTileGrid& Grid, const TArray<FIntPoint>& Planned)
+{
+	for (const int32 Index : DirtyTiles)
+	{
+		IsDirty[Index] = false;
+
+		// Solo se anaden al monticulo las casillas validas cuyo valor ha cambiado, la entrada previa queda obsoleta
+		const float Score = CalculateScore(Grid, Index, Planned);
+		if (Score == Scores[Index]) continue;
+
+		Scores[Index] = Score;
+		if (Score >= 0.0) Sites.Push(FSettlementSiteNode{Index, Score});
+	}
+
+	DirtyTiles.Reset();
+
+	// Si el monticulo acumula demasiadas entradas obsoletas, se reconstruye con los valores actuales
+	if (Sites.Num() > 4 * Scores.Num())
+	{
+		Sites.Reset();
+		for (int32 Index = 0; Index < Scores.Num(); ++Index)
+		{
+			if (Scores[Index] >= 0.0) Sites.Push(FSettlementSiteNode{Index, Scores[Index]});
+		}
+	}
+}
+
+int32 FSettlementSites::PopBest(const TFunctionRef<bool(int32 Index)> IsCandidate)
+{
+	int32 Best = -1;
+	TArray<FSettlementSiteNode> Skipped;
+
+	while (!Sites.IsEmpty())
+	{
+		// Se descartan las entradas obsoletas y las casillas que ya no son validas
+		const FSettlementSiteNode Node = Sites.Pop();
+		if (Node.Score != Scores[Node.Index] || Node.Score < 0.0) continue;
+
+		if (IsCandidate(Node.Index))
+		{
+			Best = Node.Index;
+			break;
+		}
+
+		Skipped.Add(Node);
+	}
+
+	// Las casillas descartadas por la condicion siguen siendo validas para otras consultas
+	for (const FSettlementSiteNode& Node : Skipped) Sites.Push(Node);
+
+	return Best;
+}
+
+//--------------------------------------------------------------------------------------------------------------------//
+
+void FSettlementSites::MarkDirty(const int32 Index)
+{
+	if (IsDirty[Index]) return;
+
+	IsDirty[Index] = true;
+	DirtyTiles.Add(Index);
+}
+
+void FSettlementSites::MarkDirtyAround(const FTileGrid& Grid, const int32 Index, const int32 Radius)
+{
+	ULibraryTileMap::ForEachTileInSpiral(Grid.GetPos(Index), Radius, FIntPoint(Grid.Rows, Grid.Cols),
+	                                     [&](const FIntPoint& Pos, int32) { MarkDirty(Grid.GetIndex(Pos)); });
+}
+
+float FSettlementSites::CalculateScore(const FTileGrid& Grid, const int32 Index, const TArray<FIntPoint>& Planned) const
+{
+	// Si la casilla no es accesible o contiene un recurso, no se puede establecer un asentamiento
+	if (!Grid.IsAccesible(Index) || Grid.HasResource(Index)) return -1.0;
+
+	const FIntPoint Pos = Grid.GetPos(Index);
+	const FIntPoint MapSize = FIntPoint(Grid.Rows, Grid.Cols);
+
+	// Si hay algun asentamiento o asentamiento planificado demasiado cerca, no se puede establecer un asentamiento
+	bool SettlementTooClose = false;
+	ULibraryTileMap::ForEachTileInSpiral(Pos, SettlementMinDistance, MapSize, [&](const FIntPoint& TilePos, int32)
+	{
+		SettlementTooClose |= Grid.HasSettlement(Grid.GetIndex(TilePos));
+	});
+
+	if (SettlementTooClose) return -1.0;
+
+	for (const FIntPoint& PlannedPos : Planned)
+	{
+		if (ULibraryTileMap::GetDistanceToElement(PlannedPos, Pos) <= SettlementMinDistance) return -1.0;
+	}
+
+	// Se da mas valor a las casillas cercanas al asentamiento propio mas cercano para que los asentamientos se
+	// establezcan relativamente cerca unos de otros
+	float Score = 0.0;
+	const int32 SettlementDistance = OwnedField.GetDistance(Index);
+	if (SettlementDistance != MAX_int32) Score += 10.0 / (SettlementDistance - SettlementMinDistance);
+
+	// Si la casilla tiene recursos cercanos, se aumenta el valor en funcion de la distancia
+	ULibraryTileMap::ForEachTileInSpiral(Pos, ResourceRadius, MapSize, [&](const FIntPoint& TilePos, const int32 Ring)
+	{
+		if (Ring > 0 && Grid.HasResource(Grid.GetIndex(TilePos))) Score += Ring == 1 ? 2.0 : 1.0;
+	});
+
+	return Score;
+}
@@ -0,0 +1,187 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FSettlementDistanceField.h"
+#include "FTileGrid.h"
+#include "TPriorityQueue.h"
+
+/**
+ * Estructura que almacena una casilla candidata a asentamiento junto con su valor de atractivo
+ */
+struct FSettlementSiteNode
+{
+	/**
+	 * Posicion en el Array1D de la casilla
+	 */
+	int32 Index;
+
+	/**
+	 * Valor de atractivo de la casilla, mayor es mas prioritario
+	 */
+	float Score;
+
+	bool operator<(const FSettlementSiteNode& Other) const { return Score > Other.Score; }
+};
+
+/**
+ * Clase que mantiene el valor de atractivo de cada casilla para establecer un asentamiento de una faccion. El valor
+ * depende de la distancia al asentamiento propio mas cercano y de los recursos cercanos, y es invalido (-1) si no se
+ * puede establecer un asentamiento en la casilla.
+ * 
+ * Los valores solo se recalculan en el entorno de los cambios: las casillas modificadas del mapa, los asentamientos
+ * planificados y la region en la que cambia el asentamiento propio mas cercano. Las casillas se mantienen en un
+ * monticulo con eliminacion perezosa, de forma que obtener la mejor casilla es O(log n)
+ */
+class FSettlementSites
+{
+public:
+	/**
+	 * Distancia minima entre asentamientos
+	 */
+	static constexpr int32 SettlementMinDistance = 3;
+
+	/**
+	 * Distancia maxima de los recursos que aumentan el valor de una casilla
+	 */
+	static constexpr int32 ResourceRadius = 2;
+
+	/**
+	 * Metodo que calcula los valores de todas las casillas desde cero
+	 * 
+	 * @param Grid Rejilla de casillas del mapa
+	 * @param Owned Posiciones en el Array1D de los asentamientos propios
+	 * @param Planned Posiciones de los asentamientos planificados
+	 */
+	void Init(const FTileGrid& Grid, const TArray<int32>& Owned, const TArray<FIntPoint>& Planned);
+
+	/**
+	 * Metodo que verifica si los valores se han calculado para la rejilla dada
+	 * 
+	 * @param Grid Rejilla de casillas del mapa
+	 * @return Si se pueden actualizar los valores de forma incremental
+	 */
+	bool IsInitialized(const FTileGrid& Grid) const { return Scores.Num() == Grid.Num() && Grid.Num() > 0; }
+
+	/**
+	 * Metodo que notifica que una casilla del mapa ha cambiado. Si ha cambiado su coste, su recurso o su
+	 * asentamiento, se marcan para recalcularse las casillas cuyo valor depende de ella
+	 * 
+	 * @param Grid Rejilla de casillas del mapa
+	 * @param Index Posicion en el Array1D de la casilla modificada
+	 */
+	void NotifyTileChanged(const FTileGrid& Grid, const int32 Index);
+
+	/**
+	 * Metodo que marca para recalcularse las casillas afectadas por un asentamiento planificado que se ha anadido o
+	 * eliminado
+	 * 
+	 * @param Grid Rejilla de casillas del mapa
+	 * @param Index Posicion en el Array1D del asentamiento planificado
+	 */
+	void NotifyPlannedChanged(const FTileGrid& Grid, const int32 Index);
+
+	/**
+	 * Metodo que actualiza los asentamientos propios. Solo se recalcula la distancia al asentamiento mas cercano en
+	 * la region de los asentamientos anadidos y eliminados
+	 * 
+	 * @param Grid Rejilla de casillas del mapa
+	 * @param Owned Posiciones en el Array1D de los asentamientos propios
+	 */
+	void SetOwnedSettlements(const FTileGrid& Grid, const TArray<int32>& Owned);
+
+	/**
+	 * Metodo que recalcula los valores de las casillas marcadas y los anade al monticulo
+	 * 
+	 * @param Grid Rejilla de casillas del mapa
+	 * @param Planned Posiciones de los asentamientos planificados
+	 */
+	void Update(const FTileGrid& Grid, const TArray<FIntPoint>& Planned);
+
+	/**
+	 * Metodo que extrae la casilla valida con mayor valor que cumpla la condicion dada. Las casillas que no la cumplen
+	 * se devuelven al monticulo
+	 * 
+	 * @param IsCandidate Funcion que verifica si una casilla puede elegirse
+	 * @return Posicion en el Array1D de la casilla o -1 si no existe ninguna
+	 */
+	int32 PopBest(const TFunctionRef<bool(int32 Index)> IsCandidate);
+
+	/**
+	 * Metodo que devuelve el valor de atractivo de una casilla
+	 * 
+	 * @param Index Posicion en el Array1D
+	 * @return Valor de la casilla, -1 si no es valida
+	 */
+	float GetScore(const int32 Index) const { return Scores.IsValidIndex(Index) ? Scores[Index] : -1.0; }
+
+private:
+	/**
+	 * Valor de atractivo de cada casilla, -1 si no se puede establecer un asentamiento
+	 */
+	TArray<float> Scores;
+
+	/**
+	 * Distancia de cada casilla al asentamiento propio mas cercano
+	 */
+	FSettlementDistanceField OwnedField;
+
+	/**
+	 * Datos de cada casilla de los que dependen los valores (coste, recurso y asentamiento) para descartar los
+	 * cambios que no les afectan
+	 */
+	TArray<uint8> TileStates;
+
+	/**
+	 * Casillas pendientes de recalcularse
+	 */
+	TArray<int32> DirtyTiles;
+	TBitArray<> IsDirty;
+
+	/**
+	 * Monticulo de casillas validas. Puede contener entradas obsoletas que se descartan al extraerlas
+	 */
+	TPriorityQueue<FSettlementSiteNode> Sites;
+
+	//----------------------------------------------------------------------------------------------------------------//
+
+	/**
+	 * Metodo estatico privado que obtiene los datos de una casilla de los que dependen los valores
+	 * 
+	 * @param Grid Rejilla de casillas del mapa
+	 * @param Index Posicion en el Array1D
+	 * @return Datos de la casilla codificados
+	 */
+	static uint8 GetTileState(const FTileGrid& Grid, const int32 Index)
+	{
+		return static_cast<uint8>(Grid.Costs[Index] + 1) | Grid.HasResource(Index) << 4 |
+			Grid.HasSettlement(Index) << 5;
+	}
+
+	/**
+	 * Metodo privado que marca una casilla para recalcularse
+	 * 
+	 * @param Index Posicion en el Array1D
+	 */
+	void MarkDirty(const int32 Index);
+
+	/**
+	 * Metodo privado que marca para recalcularse todas las casillas a la distancia dada o menos de una casilla
+	 * 
+	 * @param Grid Rejilla de casillas del mapa
+	 * @param Index Posicion en el Array1D de la casilla central
+	 * @param Radius Distancia maxima
+	 */
+	void MarkDirtyAround(const FTileGrid& Grid, const int32 Index, const int32 Radius);
+
+	/**
+	 * Metodo privado que calcula el valor de atractivo de una casilla
+	 * 
+	 * @param Grid Rejilla de casillas del mapa
+	 * @param Index Posicion en el Array1D
+	 * @param Planned Posiciones de los asentamientos planificados
+	 * @return Valor de la casilla, -1 si no se puede establecer un asentamiento
+	 */
+	float CalculateScore(const FTileGrid& Grid, const int32 Index, const TArray<FIntPoint>& Planned) const;
+};
@@ -0,0 +1,384 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FResourceInfo.h"
+#include "FTileInfo.h"
+#include "LibraryTileMap.h"
+
+/**
+ * Flags que indican los elementos que ocupan una casilla
+ */
+enum class ETileOccupant : uint8
+{
+	None = 0,
+	Unit = 1 << 0,
+	Settlement = 1 << 1
+};
+
+ENUM_CLASS_FLAGS(ETileOccupant)
+
+/**
+ * Estructura que almacena el estado de las casillas del mapa en arrays densos (Structure of Arrays) indexados por la
+ * posicion de la casilla en el Array1D. Es la fuente de verdad para las consultas del mapa, de forma que la busqueda
+ * de caminos y la IA leen bytes contiguos en lugar de acceder a los actores de las casillas.
+ * 
+ * Las facciones se almacenan como int8, empleando -1 para indicar que no hay propietario
+ */
+struct FTileGrid
+{
+	/**
+	 * Numero de filas del mapa
+	 */
+	int32 Rows = 0;
+
+	/**
+	 * Numero de columnas del mapa
+	 */
+	int32 Cols = 0;
+
+	/**
+	 * Tipo de cada casilla
+	 */
+	TArray<ETileType> Types;
+
+	/**
+	 * Coste de movimiento de cada casilla, -1 si es inaccesible
+	 */
+	TArray<int8> Costs;
+
+	/**
+	 * Faccion propietaria de cada casilla
+	 */
+	TArray<int8> Owners;
+
+	/**
+	 * Elementos que ocupan cada casilla
+	 */
+	TArray<ETileOccupant> Occupants;
+
+	/**
+	 * Faccion propietaria de la unidad situada en cada casilla
+	 */
+	TArray<int8> UnitOwners;
+
+	/**
+	 * Faccion propietaria del asentamiento situado en cada casilla
+	 */
+	TArray<int8> SettlementOwners;
+
+	/**
+	 * Recurso situado en cada casilla
+	 */
+	TArray<EResource> Resources;
+
+	/**
+	 * Posicion en el Array1D de los vecinos de cada casilla. Cada casilla ocupa HexNeighborsNum entradas consecutivas
+	 * y los vecinos fuera del mapa se marcan con -1
+	 */
+	TArray<int32> Neighbors;
+
+	/**
+	 * Componente conexa de cada casilla accesible, -1 si la casilla es inaccesible. Dos casillas con la misma
+	 * componente estan conectadas por casillas accesibles
+	 */
+	TArray<int32> Components;
+
+	/**
+	 * Siguiente identificador de componente libre. Las etiquetas no se reutilizan, por lo que no es el numero de
+	 * componentes actuales
+	 */
+	int32 NextComponent = 0;
+
+	/**
+	 * Si se han calculado las componentes conexas. Mientras se genera o carga el mapa no se calculan
+	 */
+	bool ComponentsBuilt = false;
+
+	//----------------------------------------------------------------------------------------------------------------//
+
+	/**
+	 * Metodo que inicializa la rejilla para las dimensiones dadas con casillas vacias y calcula la tabla de vecinos
+	 * 
+	 * @param NumRows Numero de filas del mapa
+	 * @param NumCols Numero de columnas del mapa
+	 */
+	void Init(const int32 NumRows, const int32 NumCols)
+	{
+		Rows = NumRows;
+		Cols = NumCols;
+
+		const int32 NumTiles = Rows * Cols;
+		Types.Init(ETileType::None, NumTiles);
+		Costs.Init(-1, NumTiles);
+		Owners.Init(-1, NumTiles);
+		Occupants.Init(ETileOccupant::None, NumTiles);
+		UnitOwners.Init(-1, NumTiles);
+		SettlementOwners.Init(-1, NumTiles);
+		Resources.Init(EResource::None, NumTiles);
+
+		// Las componentes se calculan una vez que el mapa esta completo
+		Components.Empty();
+		NextComponent = 0;
+		ComponentsBuilt = false;
+
+		// Se calcula la posicion en el Array1D de cada vecino o -1 si no es valido
+		const FIntPoint MapSize = FIntPoint(Rows, Cols);
+		Neighbors.SetNumUninitialized(NumTiles * HexNeighborsNum);
+
+		for (int32 Index = 0; Index < NumTiles; ++Index)
+		{
+			const FIntPoint Pos = GetPos(Index);
+			const int32 (&Offsets)[HexNeighborsNum][2] = HexNeighborsOffsets[Pos.Y & 1];
+
+			for (int32 i = 0; i < HexNeighborsNum; ++i)
+			{
+				const FIntPoint Neighbor = FIntPoint(Pos.X + Offsets[i][0], Pos.Y + Offsets[i][1]);
+				Neighbors[Index * HexNeighborsNum + i] = ULibraryTileMap::CheckValidPosition(Neighbor, MapSize)
+					                                         ? GetIndex(Neighbor)
+					                                         : -1;
+			}
+		}
+	}
+
+	/**
+	 * Metodo que devuelve el numero de casillas de la rejilla
+	 * 
+	 * @return Numero de casillas
+	 */
+	int32 Num() const { return Types.Num(); }
+
+	/**
+	 * Metodo que verifica si una posicion del Array1D pertenece a la rejilla
+	 * 
+	 * @param Index Posicion en el Array1D
+	 * @return Si la posicion es valida
+	 */
+	bool IsValidIndex(const int32 Index) const { return Types.IsValidIndex(Index); }
+
+	/**
+	 * Metodo que verifica si la rejilla corresponde a las dimensiones dadas
+	 * 
+	 * @param NumRows Numero de filas del mapa
+	 * @param NumCols Numero de columnas del mapa
+	 * @return Si la rejilla tiene las dimensiones dadas
+	 */
+	bool HasSize(const int32 NumRows, const int32 NumCols) const
+	{
+		return Rows == NumRows && Cols == NumCols && Num() == Rows * Cols;
+	}
+
+	/**
+	 * Metodo que obtiene la posicion en el Array1D de una casilla
+	 * 
+	 * @param Pos Posicion en el Array2D
+	 * @return Posicion en el Array1D o -1 si no es valida
+	 */
+	int32 GetIndex(const FIntPoint& Pos) const
+	{
+		return ULibraryTileMap::CheckValidPosition(Pos, FIntPoint(Rows, Cols)) ? Pos.X * Cols + Pos.Y : -1;
+	}
+
+	/**
+	 * Metodo que obtiene la posicion en el Array2D de una casilla
+	 * 
+	 * @param Index Posicion en el Array1D
+	 * @return Posicion en el Array2D
+	 */
+	FIntPoint GetPos(const int32 Index) const { return FIntPoint(Index / Cols, Index % Cols); }
+
+	/**
+	 * Metodo que aplica la funcion dada a la posicion en el Array1D de cada uno de los vecinos validos de una casilla
+	 * 
+	 * @param Index Posicion en el Array1D
+	 * @param Function Funcion a aplicar sobre la posicion en el Array1D de cada vecino
+	 */
+	template <typename FunctionType>
+	void ForEachNeighbor(const int32 Index, FunctionType&& Function) const
+	{
+		const int32* TileNeighbors = Neighbors.GetData() + Index * HexNeighborsNum;
+		for (int32 i = 0; i < HexNeighborsNum; ++i) if (TileNeighbors[i] != -1) Function(TileNeighbors[i]);
+	}
+
+	//----------------------------------------------------------------------------------------------------------------//
+
+	/**
+	 * Metodo que actualiza el tipo de una casilla junto con su coste de movimiento
+	 * 
+	 * @param Index Posicion en el Array1D
+	 * @param Type Tipo de casilla
+	 */
+	void SetType(const int32 Index, const ETileType Type)
+	{
+		Types[Index] = Type;
+		Costs[Index] = static_cast<int8>(ULibraryTileMap::GetTileCostFromType(Type));
+	}
+
+	/**
+	 * Metodo que actualiza la unidad de una casilla
+	 * 
+	 * @param Index Posicion en el Array1D
+	 * @param Owner Faccion propietaria de la unidad o -1 si se elimina
+	 * @param IsPresent Si la casilla contiene una unidad
+	 */
+	void SetUnit(const int32 Index, const int32 Owner, const bool IsPresent)
+	{
+		if (IsPresent) Occupants[Index] |= ETileOccupant::Unit;
+		else Occupants[Index] &= ~ETileOccupant::Unit;
+
+		UnitOwners[Index] = static_cast<int8>(IsPresent ? Owner : -1);
+	}
+
+	/**
+	 * Metodo que actualiza el asentamiento de una casilla
+	 * 
+	 * @param Index Posicion en el Array1D
+	 * @param Owner Faccion propietaria del asentamiento o -1 si se elimina
+	 * @param IsPresent Si la casilla contiene un asentamiento
+	 */
+	void SetSettlement(const int32 Index, const int32 Owner, const bool IsPresent)
+	{
+		if (IsPresent) Occupants[Index] |= ETileOccupant::Settlement;
+		else Occupants[Index] &= ~ETileOccupant::Settlement;
+
+		SettlementOwners[Index] = static_cast<int8>(IsPresent ? Owner : -1);
+	}
+
+	//----------------------------------------------------------------------------------------------------------------//
+
+	bool IsAccesible(const int32 Index) const { return Costs[Index] != -1; }
+
+	bool HasUnit(const int32 Index) const { return EnumHasAnyFlags(Occupants[Index], ETileOccupant::Unit); }
+
+	bool HasSettlement(const int32 Index) const
+	{
+		return EnumHasAnyFlags(Occupants[Index], ETileOccupant::Settlement);
+	}
+
+	bool HasElement(const int32 Index) const { return Occupants[Index] != ETileOccupant::None; }
+
+	bool HasResource(const int32 Index) const { return Resources[Index] != EResource::None; }
+
+	/**
+	 * Metodo que devuelve la faccion propietaria del elemento de una casilla. Al igual que AActorTile::GetElement,
+	 * la unidad tiene preferencia sobre el asentamiento
+	 * 
+	 * @param Index Posicion en el Array1D
+	 * @return Faccion propietaria del elemento o -1 si no hay elemento
+	 */
+	int32 GetElementOwner(const int32 Index) const
+	{
+		return HasUnit(Index) ? UnitOwners[Index] : SettlementOwners[Index];
+	}
+
+	//----------------------------------------------------------------------------------------------------------------//
+
+	/**
+	 * Metodo que etiqueta las componentes conexas de las casillas accesibles de todo el mapa
+	 */
+	void BuildComponents()
+	{
+		Components.Init(-1, Num());
+		NextComponent = 0;
+
+		TArray<int32> Stack;
+		for (int32 Index = 0; Index < Num(); ++Index)
+		{
+			if (IsAccesible(Index) && Components[Index] == -1) FloodComponent(Index, NextComponent++, Stack);
+		}
+
+		ComponentsBuilt = true;
+	}
+
+	/**
+	 * Metodo que actualiza las componentes conexas tras cambiar la accesibilidad de una casilla. Solo se vuelven a
+	 * etiquetar las componentes afectadas por el cambio
+	 * 
+	 * @param Index Posicion en el Array1D de la casilla modificada
+	 * @param WasAccesible Si la casilla era accesible antes del cambio
+	 */
+	void UpdateComponentsAt(const int32 Index, const bool WasAccesible)
+	{
+		if (!ComponentsBuilt || IsAccesible(Index) == WasAccesible) return;
+
+		TArray<int32> Stack;
+		if (IsAccesible(Index))
+		{
+			// Si todos los vecinos accesibles pertenecen a la misma componente, la casilla se une a ella. En caso
+			// contrario, la casilla une varias componentes y se etiquetan todas de nuevo
+			int32 Label = -1;
+			bool Merge = false;
+			ForEachNeighbor(Index, [&](const int32 Neighbor)
+			{
+				if (Components[Neighbor] == -1) return;
+				if (Label == -1) Label = Components[Neighbor];
+				else if (Components[Neighbor] != Label) Merge = true;
+			});
+
+			if (Label != -1 && !Merge) Components[Index] = Label;
+			else FloodComponent(Index, NextComponent++, Stack);
+		}
+		else
+		{
+			// La casilla puede dividir su componente, por lo que se etiqueta de nuevo la region de cada vecino que
+			// no se haya alcanzado ya desde otro vecino
+			Components[Index] = -1;
+
+			const int32 FirstLabel = NextComponent;
+			ForEachNeighbor(Index, [&](const int32 Neighbor)
+			{
+				if (Components[Neighbor] != -1 && Components[Neighbor] < FirstLabel)
+				{
+					FloodComponent(Neighbor, NextComponent++, Stack);
+				}
+			});
+		}
+	}
+
+	/**
+	 * Metodo que verifica si dos casillas estan conectadas por casillas accesibles. Si las componentes no se han
+	 * calculado, no se descarta ninguna conexion
+	 * 
+	 * @param IndexA Posicion en el Array1D de la primera casilla
+	 * @param IndexB Posicion en el Array1D de la segunda casilla
+	 * @return Si existe algun camino entre ambas casillas
+	 */
+	bool AreConnected(const int32 IndexA, const int32 IndexB) const
+	{
+		if (!ComponentsBuilt) return true;
+		return Components[IndexA] != -1 && Components[IndexA] == Components[IndexB];
+	}
+
+private:
+	/**
+	 * Metodo privado que asigna una etiqueta a todas las casillas accesibles conectadas con la casilla dada
+	 * 
+	 * @param Start Posicion en el Array1D de la casilla inicial
+	 * @param Label Etiqueta de la componente
+	 * @param Stack Pila reutilizable para el recorrido
+	 */
+	void FloodComponent(const int32 Start, const int32 Label, TArray<int32>& Stack)
+	{
+		Stack.Reset();
+		Stack.Push(Start);
+		Components[Start] = Label;
+
+		while (Stack.Num() > 0)
+		{
+			ForEachNeighbor(Stack.Pop(false), [&](const int32 Neighbor)
+			{
+				if (IsAccesible(Neighbor) && Components[Neighbor] != Label)
+				{
+					Components[Neighbor] = Label;
+					Stack.Push(Neighbor);
+				}
+			});
+		}
+	}
+};
+
+/**
+ * Copia inmutable de la rejilla de casillas. Puede compartirse con otros hilos mientras el mapa sigue modificandose
+ */
+using FTileGridSnapshot = TSharedRef<const FTileGrid, ESPMode::ThreadSafe>;
@@ -5,18 +5,22 @@
 
 #include "ActorTileMap.h"
 
-FVector ULibraryTileMap::OffsetCoordsToCubeCoords(const FIntPoint& OffsetCoords)
+TArray<FIntPoint> ULibraryTileMap::BuildSpiralOffsets(const int32 Parity)
 {
-	const int32 X = OffsetCoords.Y;
-	const int32 Y = OffsetCoords.X - (OffsetCoords.Y - (OffsetCoords.Y & 1)) / 2;
-	return FVector(X, Y, -X - Y);
-}
+	TArray<FIntPoint> Offsets;
+	Offsets.Reserve(GetSpiralNum(HexSpiralMaxRadius));
 
-FVector2D ULibraryTileMap::CubeCoordsToOffsetCoords(const FIntVector& CubeCoords)
-{
-	const int32 Row = CubeCoords.Y + (CubeCoords.X - (CubeCoords.X & 1)) / 2;
-	const int32 Col = CubeCoords.X;
-	return FVector2D(Row, Col);
+	// Se generan los anillos alrededor de una casilla con la paridad dada y se almacena el desplazamiento relativo
+	const FIntPoint Center = FIntPoint(0, Parity);
+	for (int32 Radius = 0; Radius <= HexSpiralMaxRadius; ++Radius)
+	{
+		FCubeCoords::ForEachInRing(FCubeCoords::FromOffset(Center), Radius, [&](const FCubeCoords& Coords)
+		{
+			Offsets.Add(Coords.ToOffset() - Center);
+		});
+	}
+
+	return Offsets;
 }
 
 //--------------------------------------------------------------------------------------------------------------------//
@@ -28,30 +32,34 @@ bool ULibraryTileMap::CheckValidPosition(const FIntPoint& Pos, const FIntPoint&
 
 //--------------------------------------------------------------------------------------------------------------------//
 
-TArray<FIntPoint> ULibraryTileMap::GetNeighbors(const FIntPoint& Pos, const FIntPoint& MapSize)
+void ULibraryTileMap::FillNeighbors(const FIntPoint& Pos, const FIntPoint& MapSize, FTileNeighbors& Neighbors)
 {
-	// Se preasigna el desplazamiento en funcion de si la columna es par o impar
-	TArray<FIntPoint> AllNeighbors = Pos.Y % 2 == 0
-		                                 ? TArray<FIntPoint>{
-			                                 FIntPoint(-1, -1), FIntPoint(-1, 0), FIntPoint(-1, 1),
-			                                 FIntPoint(0, 1), FIntPoint(1, 0), FIntPoint(0, -1)
-		                                 }
-		                                 : TArray<FIntPoint>{
-			                                 FIntPoint(0, -1), FIntPoint(-1, 0), FIntPoint(0, 1),
-			                                 FIntPoint(1, 1), FIntPoint(1, 0), FIntPoint(1, -1)
-		                                 };
+	Neighbors.Reset();
+	ForEachNeighbor(Pos, MapSize, [&Neighbors](const FIntPoint& Neighbor) { Neighbors.Add(Neighbor); });
+}
 
+TArray<FIntPoint> ULibraryTileMap::GetNeighbors(const FIntPoint& Pos, const FIntPoint& MapSize)
+{
 	// Se actualizan las posiciones de los vecinos y se comprueba si son correctas
 	TArray<FIntPoint> Neighbors;
-	for (int32 i = 0; i < AllNeighbors.Num(); ++i)
-	{
-		AllNeighbors[i] += Pos;
-		if (CheckValidPosition(AllNeighbors[i], MapSize)) Neighbors.Add(AllNeighbors[i]);
-	}
+	Neighbors.Reserve(HexNeighborsNum);
+	ForEachNeighbor(Pos, MapSize, [&Neighbors](const FIntPoint& Neighbor) { Neighbors.Add(Neighbor); });
 
 	return Neighbors;
 }
 
+//--------------------------------------------------------------------------------------------------------------------//
+
+const TArray<FIntPoint>& ULibraryTileMap::GetSpiralOffsets(const int32 Parity)
+{
+	// Las tablas se calculan una unica vez para cada paridad
+	static const TArray<FIntPoint> SpiralOffsets[2] = {BuildSpiralOffsets(0), BuildSpiralOffsets(1)};
+
+	return SpiralOffsets[Parity & 1];
+}
+
+//--------------------------------------------------------------------------------------------------------------------//
+
 FIntPoint ULibraryTileMap::GetClosestElementFromPos(const FIntPoint& Pos, const TSet<FIntPoint>& ElementsLocation)
 {
 	FIntPoint ElementPos = FIntPoint(-1);
@@ -59,25 +67,43 @@ FIntPoint ULibraryTileMap::GetClosestElementFromPos(const FIntPoint& Pos, const
 	// Si no hay elementos en la coleccion, se devuelve un valor invalido
 	if (ElementsLocation.Num() == 0) return ElementPos;
 
-	// Se procesan todos los elementos y se calcula el elemento mas cercano
+	// Se calculan las distancias a todos los elementos en un unico recorrido y se obtiene el elemento mas cercano
+	const TArray<FIntPoint> Locations = ElementsLocation.Array();
+	TArray<int32> Distances;
+	GetDistancesToElements(Pos, Locations, Distances);
+
 	int32 MinDistance = 999;
-	for (auto ElementLocation : ElementsLocation)
+	for (int32 i = 0; i < Locations.Num(); ++i)
 	{
-		const int32 Distance = GetDistanceToElement(Pos, ElementLocation);
-		if (Distance < MinDistance)
+		if (Distances[i] < MinDistance)
 		{
-			ElementPos = ElementLocation;
-			MinDistance = Distance;
+			ElementPos = Locations[i];
+			MinDistance = Distances[i];
 		}
 	}
 
 	return ElementPos;
 }
 
-int32 ULibraryTileMap::GetDistanceToElement(const FIntPoint& PosIni, const FIntPoint& PosEnd)
+void ULibraryTileMap::GetDistancesToElements(const FIntPoint& Pos, const TArray<FIntPoint>& ElementsLocation,
+                                             TArray<int32>& Distances)
 {
-	const FVector Distance = OffsetCoordsToCubeCoords(PosEnd) - OffsetCoordsToCubeCoords(PosIni);
-	return FMath::Max3(FMath::Abs(Distance.X), FMath::Abs(Distance.Y), FMath::Abs(Distance.Z));
+	const int32 Num = ElementsLocation.Num();
+
+	// Se separan las coordenadas cubicas de los destinos por componente para el calculo en bloque
+	TArray<int32, TInlineAllocator<64>> CubeX, CubeY;
+	CubeX.SetNumUninitialized(Num);
+	CubeY.SetNumUninitialized(Num);
+
+	for (int32 i = 0; i < Num; ++i)
+	{
+		const FCubeCoords Coords = FCubeCoords::FromOffset(ElementsLocation[i]);
+		CubeX[i] = Coords.X;
+		CubeY[i] = Coords.Y;
+	}
+
+	Distances.SetNumUninitialized(Num);
+	FCubeCoords::Distances(FCubeCoords::FromOffset(Pos), CubeX.GetData(), CubeY.GetData(), Num, Distances.GetData());
 }
 
 //--------------------------------------------------------------------------------------------------------------------//
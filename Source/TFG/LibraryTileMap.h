@@ -3,11 +3,36 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "FCubeCoords.h"
 #include "FMovement.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
 #include "LibraryTileMap.generated.h"
 
 enum class ETileType : uint8;
+
+/**
+ * Numero de vecinos de una casilla hexagonal
+ */
+constexpr int32 HexNeighborsNum = 6;
+
+/**
+ * Desplazamientos (fila, columna) de las casillas vecinas en funcion de si la columna es par [0] o impar [1]
+ */
+constexpr int32 HexNeighborsOffsets[2][HexNeighborsNum][2] = {
+	{{-1, -1}, {-1, 0}, {-1, 1}, {0, 1}, {1, 0}, {0, -1}},
+	{{0, -1}, {-1, 0}, {0, 1}, {1, 1}, {1, 0}, {1, -1}}
+};
+
+/**
+ * Radio maximo para el que se precalculan las tablas de anillos y espirales
+ */
+constexpr int32 HexSpiralMaxRadius = 10;
+
+/**
+ * Array de vecinos de una casilla que no requiere memoria dinamica
+ */
+typedef TArray<FIntPoint, TInlineAllocator<HexNeighborsNum>> FTileNeighbors;
+
 /**
  * 
  */
@@ -16,8 +41,14 @@ class TFG_API ULibraryTileMap : public UBlueprintFunctionLibrary
 {
 	GENERATED_BODY()
 
-	static FVector OffsetCoordsToCubeCoords(const FIntPoint& OffsetCoords);
-	static FVector2D CubeCoordsToOffsetCoords(const FIntVector& CubeCoords);
+	/**
+	 * Metodo estatico privado que calcula los desplazamientos relativos de la espiral hasta el radio maximo para
+	 * una paridad de columna
+	 * 
+	 * @param Parity Paridad de la columna central (0 par, 1 impar)
+	 * @return Desplazamientos (fila, columna) ordenados por anillos
+	 */
+	static TArray<FIntPoint> BuildSpiralOffsets(const int32 Parity);
 
 public:
 	/**
@@ -32,13 +63,140 @@ public:
 
 	//----------------------------------------------------------------------------------------------------------------//
 
+	/**
+	 * Metodo estatico que aplica la funcion dada a cada una de las casillas vecinas validas de una posicion sin
+	 * reservar memoria dinamica
+	 * 
+	 * @param Pos Posicion de la casilla
+	 * @param MapSize Tamano del mapa
+	 * @param Function Funcion a aplicar sobre la posicion de cada vecino
+	 */
+	template <typename FunctionType>
+	static void ForEachNeighbor(const FIntPoint& Pos, const FIntPoint& MapSize, FunctionType&& Function)
+	{
+		// Se selecciona el desplazamiento en funcion de si la columna es par o impar
+		const int32 (&Offsets)[HexNeighborsNum][2] = HexNeighborsOffsets[Pos.Y & 1];
+
+		for (int32 i = 0; i < HexNeighborsNum; ++i)
+		{
+			const FIntPoint Neighbor = FIntPoint(Pos.X + Offsets[i][0], Pos.Y + Offsets[i][1]);
+			if (CheckValidPosition(Neighbor, MapSize)) Function(Neighbor);
+		}
+	}
+
+	/**
+	 * Metodo estatico que obtiene las casillas vecinas validas de una posicion en un array sin memoria dinamica
+	 * 
+	 * @param Pos Posicion de la casilla
+	 * @param MapSize Tamano del mapa
+	 * @param Neighbors Array en el que se almacenan los vecinos
+	 */
+	static void FillNeighbors(const FIntPoint& Pos, const FIntPoint& MapSize, FTileNeighbors& Neighbors);
+
 	UFUNCTION(BlueprintCallable)
 	static TArray<FIntPoint> GetNeighbors(const FIntPoint& Pos, const FIntPoint& MapSize);
 
+	//----------------------------------------------------------------------------------------------------------------//
+
+	/**
+	 * Metodo estatico que devuelve la tabla precalculada de desplazamientos relativos de la espiral hexagonal para la
+	 * paridad de columna dada. Los desplazamientos estan ordenados por anillos, de forma que el anillo de radio R
+	 * ocupa el intervalo [GetSpiralNum(R - 1), GetSpiralNum(R))
+	 * 
+	 * @param Parity Paridad de la columna central (0 par, 1 impar)
+	 * @return Desplazamientos (fila, columna) hasta el radio HexSpiralMaxRadius
+	 */
+	static const TArray<FIntPoint>& GetSpiralOffsets(const int32 Parity);
+
+	/**
+	 * Metodo estatico que devuelve el numero de casillas de una espiral hexagonal de radio dado
+	 * 
+	 * @param Radius Radio de la espiral
+	 * @return Numero de casillas a distancia menor o igual que el radio
+	 */
+	static constexpr int32 GetSpiralNum(const int32 Radius) { return Radius < 0 ? 0 : 1 + 3 * Radius * (Radius + 1); }
+
+	/**
+	 * Metodo estatico que aplica la funcion dada a cada una de las casillas validas que se encuentran exactamente a
+	 * la distancia dada de una posicion sin tener en cuenta el coste de movimiento
+	 * 
+	 * @param Center Posicion central
+	 * @param Radius Distancia de las casillas a la posicion central
+	 * @param MapSize Tamano del mapa
+	 * @param Function Funcion a aplicar sobre la posicion de cada casilla
+	 */
+	template <typename FunctionType>
+	static void ForEachTileInRing(const FIntPoint& Center, const int32 Radius, const FIntPoint& MapSize,
+	                              FunctionType&& Function)
+	{
+		if (Radius < 0) return;
+
+		// Si el radio excede las tablas precalculadas, se generan las coordenadas del anillo
+		if (Radius > HexSpiralMaxRadius)
+		{
+			FCubeCoords::ForEachInRing(FCubeCoords::FromOffset(Center), Radius, [&](const FCubeCoords& Coords)
+			{
+				const FIntPoint Pos = Coords.ToOffset();
+				if (CheckValidPosition(Pos, MapSize)) Function(Pos);
+			});
+			return;
+		}
+
+		// Se recorre el intervalo de la tabla que corresponde al anillo descartando las posiciones fuera del mapa
+		const TArray<FIntPoint>& Offsets = GetSpiralOffsets(Center.Y & 1);
+		for (int32 i = GetSpiralNum(Radius - 1); i < GetSpiralNum(Radius); ++i)
+		{
+			const FIntPoint Pos = Center + Offsets[i];
+			if (CheckValidPosition(Pos, MapSize)) Function(Pos);
+		}
+	}
+
+	/**
+	 * Metodo estatico que aplica la funcion dada a cada una de las casillas validas que se encuentran a una distancia
+	 * menor o igual que la dada de una posicion, incluida la propia posicion, en orden creciente de distancia
+	 * 
+	 * @param Center Posicion central
+	 * @param Radius Distancia maxima de las casillas a la posicion central
+	 * @param MapSize Tamano del mapa
+	 * @param Function Funcion a aplicar sobre la posicion de cada casilla y su distancia a la posicion central
+	 */
+	template <typename FunctionType>
+	static void ForEachTileInSpiral(const FIntPoint& Center, const int32 Radius, const FIntPoint& MapSize,
+	                                FunctionType&& Function)
+	{
+		for (int32 Ring = 0; Ring <= Radius; ++Ring)
+		{
+			ForEachTileInRing(Center, Ring, MapSize, [&](const FIntPoint& Pos) { Function(Pos, Ring); });
+		}
+	}
+
+	//----------------------------------------------------------------------------------------------------------------//
+
 	UFUNCTION(BlueprintCallable)
 	static FIntPoint GetClosestElementFromPos(const FIntPoint& Pos, const TSet<FIntPoint>& ElementsLocation);
 
-	static int32 GetDistanceToElement(const FIntPoint& PosIni, const FIntPoint& PosEnd);
+	/**
+	 * Metodo estatico que calcula la distancia en casillas entre dos posiciones empleando coordenadas cubicas enteras
+	 * 
+	 * @param PosIni Posicion inicial
+	 * @param PosEnd Posicion final
+	 * @return Numero de casillas entre ambas posiciones
+	 */
+	static int32 GetDistanceToElement(const FIntPoint& PosIni, const FIntPoint& PosEnd)
+	{
+		return FCubeCoords::Distance(FCubeCoords::FromOffset(PosIni), FCubeCoords::FromOffset(PosEnd));
+	}
+
+	/**
+	 * Metodo estatico que calcula la distancia en casillas desde una posicion hasta cada una de las posiciones dadas
+	 * en un unico recorrido vectorizable
+	 * 
+	 * @param Pos Posicion de origen
+	 * @param ElementsLocation Posiciones de destino
+	 * @param Distances Array en el que se almacenan las distancias en el mismo orden que las posiciones
+	 */
+	static void GetDistancesToElements(const FIntPoint& Pos, const TArray<FIntPoint>& ElementsLocation,
+	                                   TArray<int32>& Distances);
 
 	//----------------------------------------------------------------------------------------------------------------//
 
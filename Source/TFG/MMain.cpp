@@ -459,6 +459,10 @@ void AMMain::NextTurn() const
 	// Se verifica que la instancia del estado sea valida
 	if (!State) return;
 
+	// Se lanza el analisis de la siguiente faccion, si no se ha lanzado al terminar el turno anterior, para que avance
+	// mientras se prepara su turno
+	PrepareNextTurnAnalysis();
+
 	// Se obtiene la faccion
 	if (APawnFaction* CurrentFaction = State->NextFaction())
 	{
@@ -480,3 +484,18 @@ void AMMain::NextTurn() const
 		}
 	}
 }
+
+void AMMain::PrepareNextTurnAnalysis() const
+{
+	// Se verifica que la instancia del estado sea valida
+	if (!State) return;
+
+	// Si la siguiente faccion es un agente, se lanza el analisis de su turno en otro hilo
+	if (const APawnFaction* NextFaction = State->GetNextFaction())
+	{
+		if (ACMainAI* AIController = Cast<ACMainAI>(NextFaction->GetController()))
+		{
+			AIController->PrepareTurnAnalysis();
+		}
+	}
+}
@@ -103,6 +103,8 @@ public:
 	UFUNCTION(BlueprintCallable)
 	void NextTurn() const;
 
+	void PrepareNextTurnAnalysis() const;
+
 	//----------------------------------------------------------------------------------------------------------------//
 
 	UPROPERTY(BlueprintAssignable)
@@ -3,7 +3,9 @@
 #include "PawnFaction.h"
 
 #include "ActorSettlement.h"
+#include "ActorTileMap.h"
 #include "LibraryDataTables.h"
+#include "Kismet/GameplayStatics.h"
 
 // Sets default values
 APawnFaction::APawnFaction()
@@ -17,6 +19,9 @@ APawnFaction::APawnFaction()
 	// Se inicializa el indice de la faccion
 	Info.Index = 0;
 
+	// Se inicializa la referencia al mapa, que se obtiene al iniciar el juego
+	TileMap = nullptr;
+
 	// Se inicializa la fuerza militar de la faccion
 	Info.MilitaryStrength = 0.0;
 
@@ -147,6 +152,9 @@ void APawnFaction::AddKnowFaction(const int32 Faction, const FOpponentFactionInf
 void APawnFaction::BeginPlay()
 {
 	Super::BeginPlay();
+
+	// Se obtiene la referencia al mapa para mantener actualizada la faccion de los elementos situados en el
+	TileMap = Cast<AActorTileMap>(UGameplayStatics::GetActorOfClass(GetWorld(), AActorTileMap::StaticClass()));
 }
 
 //--------------------------------------------------------------------------------------------------------------------//
@@ -205,6 +213,7 @@ void APawnFaction::AddSettlement(AActorSettlement* Settlement)
 {
 	// Se establece la faccion actual como propietaria del asentamiento
 	Settlement->SetFactionOwner(Info.Index);
+	if (TileMap) TileMap->UpdateElementsOwner(Settlement->GetPos());
 
 	// Se anade el asentamiento a la lista
 	Info.Settlements.AddUnique(Settlement);
@@ -240,6 +249,7 @@ void APawnFaction::AddUnit(AActorUnit* Unit)
 {
 	// Se establece la faccion actual como propietaria de la unidad
 	Unit->SetFactionOwner(Info.Index);
+	if (TileMap) TileMap->UpdateElementsOwner(Unit->GetPos());
 
 	// Se anade la unidad a la lista
 	Info.Units.AddUnique(Unit);
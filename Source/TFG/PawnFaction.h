@@ -12,6 +12,7 @@
 #include "PawnFaction.generated.h"
 
 class AActorSettlement;
+class AActorTileMap;
 enum class ESettlementState : uint8;
 class AActorDamageableElement;
 
@@ -36,6 +37,9 @@ protected:
 	UPROPERTY(VisibleInstanceOnly, BlueprintReadWrite, Category="Info")
 	FFactionInfo Info;
 
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadWrite, Category="Info|AditionalData")
+	AActorTileMap* TileMap;
+
 public:
 	/**
 	 * Constructor por defecto
@@ -120,6 +120,22 @@ APawnFaction* ASMain::NextFaction()
 	return CurrentFaction;
 }
 
+APawnFaction* ASMain::GetNextFaction() const
+{
+	// Si el array esta vacio, no hay siguiente faccion
+	if (FactionsAlive.Num() == 0) return nullptr;
+
+	// Se recorren los indices a partir de la faccion actual hasta encontrar una faccion en juego
+	int32 Index = CurrentFaction ? CurrentIndex : NumFactions - 1;
+	for (int32 i = 0; i < NumFactions; ++i)
+	{
+		Index = (Index + 1) % NumFactions;
+		if (FactionsAlive.Contains(Index)) return Factions.FindRef(Index);
+	}
+
+	return nullptr;
+}
+
 //--------------------------------------------------------------------------------------------------------------------//
 
 void ASMain::UpdateWarsTurns()
@@ -172,6 +172,13 @@ public:
 	 */
 	APawnFaction* NextFaction();
 
+	/**
+	 * Metodo que obtiene la faccion que jugara el siguiente turno sin modificar la faccion actual
+	 * 
+	 * @return Siguiente faccion en juego
+	 */
+	APawnFaction* GetNextFaction() const;
+
 	//----------------------------------------------------------------------------------------------------------------//
 
 	void UpdateWarsTurns();
@@ -3,21 +3,96 @@
 #pragma once
 
 /**
- * Clase para definir colas con prioridad
+ * Clase para definir colas con prioridad. Se implementa como un monticulo binario de minimos, de forma que el
+ * elemento con mayor prioridad es aquel que es menor segun el operador < del tipo de dato.
+ * 
+ * En caso de empate, se devuelve primero el elemento que se inserto antes (orden estable). Para actualizar la
+ * prioridad de un elemento (decrease-key) se debe insertar de nuevo y descartar la entrada obsoleta al extraerla
+ * (eliminacion perezosa)
  */
 template <class T>
 class TPriorityQueue
 {
 	/**
-	 * Lista de elementos parametrizada, el tipo de dato debe proporcionar los operadores implementados
+	 * Nodo del monticulo. Almacena el elemento junto con su orden de insercion para desempatar
 	 */
-	TArray<T> Elements;
+	struct FNode
+	{
+		T Element;
+		uint64 Order;
+	};
+
+	/**
+	 * Lista de nodos que representan el monticulo, el tipo de dato debe proporcionar el operador <
+	 */
+	TArray<FNode> Elements;
+
+	/**
+	 * Contador de inserciones para mantener el orden estable entre elementos con la misma prioridad
+	 */
+	uint64 NextOrder;
+
+	/**
+	 * Metodo privado que determina si un nodo tiene mas prioridad que otro
+	 * 
+	 * @param A Primer nodo
+	 * @param B Segundo nodo
+	 * @return Si el primer nodo debe extraerse antes que el segundo
+	 */
+	static bool HasMorePriority(const FNode& A, const FNode& B)
+	{
+		if (A.Element < B.Element) return true;
+		if (B.Element < A.Element) return false;
+
+		return A.Order < B.Order;
+	}
+
+	/**
+	 * Metodo privado que desplaza un nodo hacia la raiz hasta restablecer la propiedad del monticulo
+	 * 
+	 * @param Index Indice del nodo a desplazar
+	 */
+	void SiftUp(int32 Index)
+	{
+		while (Index > 0)
+		{
+			const int32 Parent = (Index - 1) / 2;
+			if (!HasMorePriority(Elements[Index], Elements[Parent])) break;
+
+			Elements.Swap(Index, Parent);
+			Index = Parent;
+		}
+	}
+
+	/**
+	 * Metodo privado que desplaza un nodo hacia las hojas hasta restablecer la propiedad del monticulo
+	 * 
+	 * @param Index Indice del nodo a desplazar
+	 */
+	void SiftDown(int32 Index)
+	{
+		const int32 Num = Elements.Num();
+		while (true)
+		{
+			const int32 Left = 2 * Index + 1;
+			if (Left >= Num) break;
+
+			// Se obtiene el hijo con mayor prioridad
+			const int32 Right = Left + 1;
+			const int32 Child = Right < Num && HasMorePriority(Elements[Right], Elements[Left]) ? Right : Left;
+
+			if (!HasMorePriority(Elements[Child], Elements[Index])) break;
+
+			Elements.Swap(Index, Child);
+			Index = Child;
+		}
+	}
 
 public:
 	/**
 	 * Constructor por defecto de la clase
 	 */
-	TPriorityQueue(): Elements(TArray<T>())
+	TPriorityQueue(): Elements(TArray<FNode>()), NextOrder(0)
 	{
 	}
 
@@ -29,7 +104,9 @@ public:
 	 */
 	bool Contains(const T& Element) const
 	{
-		return Elements.Contains(Element);
+		for (const FNode& Node : Elements) if (Node.Element == Element) return true;
+
+		return false;
 	}
 
 	/**
@@ -43,35 +120,61 @@ public:
 	}
 
 	/**
-	 * Metodo que inserta de forma ordenada el elemento dado segun su prioridad
+	 * Metodo que devuelve el numero de elementos de la cola
+	 * 
+	 * @return Numero de elementos almacenados
+	 */
+	int32 Num() const
+	{
+		return Elements.Num();
+	}
+
+	/**
+	 * Metodo que reserva memoria para el numero de elementos dado
+	 * 
+	 * @param Number Numero de elementos a reservar
+	 */
+	void Reserve(const int32 Number)
+	{
+		Elements.Reserve(Number);
+	}
+
+	/**
+	 * Metodo que inserta el elemento dado segun su prioridad en O(log n)
 	 * 
 	 * @param Element Elemento a insertar
 	 */
 	void Push(const T& Element)
 	{
-		// Se comprueba si el elemento tiene menos prioridad que el ultimo para evitar recorrer todo el array
-		if (IsEmpty() || Element >= Elements.Last()) Elements.Add(Element);
-		else
-			for (int32 i = 0; i < Elements.Num(); ++i)
-			{
-				// Si el elemento tiene menos prioridad se inserta y se finaliza
-				if (Elements[i] >= Element)
-				{
-					Elements.Insert(Element, i);
-					break;
-				}
-			}
+		Elements.Add(FNode{Element, NextOrder++});
+		SiftUp(Elements.Num() - 1);
+	}
+
+	/**
+	 * Metodo que devuelve el elemento con mayor prioridad sin extraerlo de la cola
+	 * 
+	 * @return El elemento con mayor prioridad
+	 */
+	const T& Top() const
+	{
+		check(!IsEmpty());
+		return Elements[0].Element;
 	}
 
 	/**
-	 * Metodo que devuelve el elemento con mayor prioridad del array
+	 * Metodo que extrae el elemento con mayor prioridad de la cola en O(log n)
 	 * 
-	 * @return El primer elemento del array
+	 * @return El elemento con mayor prioridad o un elemento por defecto si la cola esta vacia
 	 */
 	T Pop()
 	{
-		T Element = !IsEmpty() ? Elements[0] : T();
-		Elements.RemoveAt(0);
+		if (IsEmpty()) return T();
+
+		T Element = Elements[0].Element;
+
+		// Se sustituye la raiz por el ultimo elemento y se restablece la propiedad del monticulo
+		Elements.RemoveAtSwap(0, 1, false);
+		if (!IsEmpty()) SiftDown(0);
 
 		return Element;
 	}
@@ -82,5 +185,15 @@ public:
 	void Empty()
 	{
 		Elements.Empty();
+		NextOrder = 0;
+	}
+
+	/**
+	 * Metodo que elimina todas las entradas de la lista manteniendo la memoria reservada
+	 */
+	void Reset()
+	{
+		Elements.Reset();
+		NextOrder = 0;
 	}
 };